@@ -0,0 +1,265 @@
+#ifndef ARENA_ALLOCATOR_HPP
+#define ARENA_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace boost { namespace geometry {
+
+namespace model {
+
+// Memory resource allocating from blocks of growing size. Deallocation does nothing,
+// the memory is freed at once by release() or by the destructor.
+// NOTE: Not thread-safe.
+class monotonic_arena
+    : boost::noncopyable
+{
+    struct block
+    {
+        block * next;
+        std::size_t size;
+    };
+
+    static const std::size_t header_size
+        = (sizeof(block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+public:
+    explicit monotonic_arena(std::size_t initial_size = 4096)
+        : m_initial_size((std::max)(initial_size, std::size_t(64)))
+        , m_next_size(m_initial_size)
+    {}
+
+    ~monotonic_arena()
+    {
+        release();
+    }
+
+    void * allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        void * ptr = align(size, alignment);
+        if (ptr == nullptr)
+        {
+            add_block(size + alignment);
+            ptr = align(size, alignment);
+        }
+        m_current = static_cast<char *>(ptr) + size;
+        return ptr;
+    }
+
+    // Frees all blocks. The memory allocated from the arena can't be used afterwards.
+    void release() noexcept
+    {
+        while (m_blocks != nullptr)
+        {
+            block * next = m_blocks->next;
+            ::operator delete(m_blocks);
+            m_blocks = next;
+        }
+        m_current = nullptr;
+        m_end = nullptr;
+        m_next_size = m_initial_size;
+        m_reserved = 0;
+    }
+
+    // Frees all blocks and allocates one block as big as all of them together so
+    // the same sequence of allocations can be repeated without allocating memory.
+    // The memory allocated from the arena can't be used afterwards.
+    void reset()
+    {
+        if (m_blocks == nullptr)
+        {
+            return;
+        }
+        if (m_blocks->next == nullptr)
+        {
+            m_current = reinterpret_cast<char *>(m_blocks) + header_size;
+            return;
+        }
+        std::size_t const size = m_reserved;
+        release();
+        m_next_size = size;
+        add_block(size - header_size);
+    }
+
+    // Size of all blocks allocated so far
+    std::size_t reserved() const
+    {
+        return m_reserved;
+    }
+
+private:
+    void * align(std::size_t size, std::size_t alignment)
+    {
+        if (m_current == nullptr)
+        {
+            return nullptr;
+        }
+        void * ptr = m_current;
+        std::size_t space = std::size_t(m_end - m_current);
+        return std::align(alignment, size, ptr, space);
+    }
+
+    void add_block(std::size_t min_size)
+    {
+        std::size_t size = m_next_size;
+        while (size - header_size < min_size)
+        {
+            size *= 2;
+        }
+
+        block * b = static_cast<block *>(::operator new(size));
+        b->next = m_blocks;
+        b->size = size;
+        m_blocks = b;
+        m_current = reinterpret_cast<char *>(b) + header_size;
+        m_end = reinterpret_cast<char *>(b) + size;
+        m_next_size = size * 2;
+        m_reserved += size;
+    }
+
+    std::size_t m_initial_size;
+    std::size_t m_next_size;
+    block * m_blocks = nullptr;
+    char * m_current = nullptr;
+    char * m_end = nullptr;
+    std::size_t m_reserved = 0;
+};
+
+} // namespace model
+
+namespace detail { namespace arena {
+
+inline model::monotonic_arena *& current()
+{
+    static thread_local model::monotonic_arena * arena = nullptr;
+    return arena;
+}
+
+}} // namespace detail::arena
+
+namespace model {
+
+// Sets the arena used by default constructed arena_allocators in the current thread
+// for the lifetime of this object.
+class arena_scope
+    : boost::noncopyable
+{
+public:
+    explicit arena_scope(monotonic_arena & arena)
+        : m_previous(geometry::detail::arena::current())
+    {
+        geometry::detail::arena::current() = &arena;
+    }
+
+    ~arena_scope()
+    {
+        geometry::detail::arena::current() = m_previous;
+    }
+
+private:
+    monotonic_arena * m_previous;
+};
+
+// Allocator using the arena of the innermost arena_scope at the time of construction,
+// or operator new and delete if there is none. It can be passed as the Allocator of
+// model::geometry_collection, model::linestring, model::polygon, etc. Containers
+// default construct their allocators so all levels of nested geometries created
+// within an arena_scope are allocated from the same arena, e.g.:
+//     monotonic_arena arena;
+//     {
+//         arena_scope scope(arena);
+//         gc_t gc;
+//         read_wkt(wkt, gc);
+//         ...
+//     }
+//     arena.release();
+// NOTE: Copies of containers are allocated from the current arena, not from the arena
+//   of the copied container. Moved containers keep their arena.
+// NOTE: Geometries allocated from an arena can't be used after the arena is released.
+//   Destroying them is not needed if their elements are trivially destructible.
+template <typename T>
+class arena_allocator
+{
+    template <typename U> friend class arena_allocator;
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef arena_allocator<U> other;
+    };
+
+    arena_allocator() noexcept
+        : m_arena(geometry::detail::arena::current())
+    {}
+
+    explicit arena_allocator(monotonic_arena * arena) noexcept
+        : m_arena(arena)
+    {}
+
+    template <typename U>
+    arena_allocator(arena_allocator<U> const& other) noexcept
+        : m_arena(other.m_arena)
+    {}
+
+    T * allocate(std::size_t n)
+    {
+        if (m_arena == nullptr)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+        if (n > std::size_t(-1) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T * ptr, std::size_t n) noexcept
+    {
+        if (m_arena == nullptr)
+        {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    arena_allocator select_on_container_copy_construction() const
+    {
+        return arena_allocator();
+    }
+
+    monotonic_arena * arena() const
+    {
+        return m_arena;
+    }
+
+    template <typename U>
+    friend bool operator==(arena_allocator const& a, arena_allocator<U> const& b)
+    {
+        return a.m_arena == b.arena();
+    }
+
+    template <typename U>
+    friend bool operator!=(arena_allocator const& a, arena_allocator<U> const& b)
+    {
+        return a.m_arena != b.arena();
+    }
+
+private:
+    monotonic_arena * m_arena;
+};
+
+} // namespace model
+
+}} // namespace boost::geometry
+
+#endif // ARENA_ALLOCATOR_HPP
@@ -0,0 +1,1071 @@
+#include "arena_allocator.hpp"
+#include "boost_any.hpp"
+#include "boost_variant.hpp"
+#include "boost_variant2.hpp"
+#include "cached_envelope_collection.hpp"
+#include "collection_pairwise.hpp"
+#include "collection_rtree.hpp"
+#include "distance.hpp"
+#include "envelope.hpp"
+#include "flat_geometry_collection.hpp"
+#include "geometry.hpp"
+#include "measure.hpp"
+#include "my_geometry.hpp"
+#include "my_geometry1.hpp"
+#include "my_geometry2.hpp"
+#include "predicates.hpp"
+#include "read_wkt.hpp"
+#include "soa_geometry_collection.hpp"
+#include "visit_parallel.hpp"
+#include "wkb.hpp"
+#include "wkb_view.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bg = boost::geometry;
+
+using point = bg::model::point<double, 2, bg::cs::cartesian>;
+using linestring = bg::model::linestring<point>;
+using polygon = bg::model::polygon<point>;
+using mpoint = bg::model::multi_point<point>;
+using mlinestring = bg::model::multi_linestring<linestring>;
+using mpolygon = bg::model::multi_polygon<polygon>;
+
+struct geometry_collection1;
+using variant1 = boost::variant<point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection1>;
+struct geometry_collection1 : std::vector<variant1>
+{
+    geometry_collection1() = default;
+    geometry_collection1(std::initializer_list<variant1> l) : std::vector<variant1>(l) {}
+};
+
+struct geometry_collection2;
+using variant2 = boost::variant2::variant<point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection2>;
+struct geometry_collection2 : std::vector<variant2>
+{
+    geometry_collection2() = default;
+    geometry_collection2(std::initializer_list<variant2> l) : std::vector<variant2>(l) {}
+};
+
+using arena_linestring = bg::model::linestring<point, std::vector, bg::model::arena_allocator>;
+using arena_polygon = bg::model::polygon<point, true, true, std::vector, std::vector, bg::model::arena_allocator, bg::model::arena_allocator>;
+struct arena_collection;
+using arena_variant = boost::variant<point, arena_linestring, arena_polygon, arena_collection>;
+struct arena_collection : bg::model::geometry_collection<arena_variant, std::vector, bg::model::arena_allocator>
+{};
+
+using any_collection = bg::model::geometry_collection<boost::any>;
+using soa_collection = bg::model::soa_geometry_collection<point, linestring, polygon, mpoint, mlinestring, mpolygon>;
+
+BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(geometry_collection1, point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection1)
+BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(geometry_collection2, point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection2)
+BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(arena_collection, point, arena_linestring, arena_polygon, arena_collection)
+BOOST_GEOMETRY_REGISTER_DYNAMIC_GEOMETRY(boost::any, point, linestring, polygon, mpoint, mlinestring, mpolygon, any_collection)
+
+
+// Allocation counting
+
+static std::atomic<std::size_t> allocation_count{0};
+
+void * operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void * ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+// Branch misses counting, only available if the kernel allows perf events
+
+class branch_misses_counter
+{
+public:
+    branch_misses_counter()
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~branch_misses_counter()
+    {
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool available() const
+    {
+        return m_fd >= 0;
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop()
+    {
+        long long result = 0;
+#ifdef __linux__
+        if (m_fd >= 0)
+        {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &result, sizeof(result)) != sizeof(result))
+            {
+                result = 0;
+            }
+        }
+#endif
+        return result;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+
+// Adapters
+
+template <typename GeometryCollection, typename Point, typename Linestring>
+struct adapter
+{
+    using gc_t = GeometryCollection;
+    using point_t = Point;
+    using linestring_t = Linestring;
+
+    static const bool nesting = true;
+};
+
+struct variant_adapter : adapter<geometry_collection1, point, linestring>
+{
+    static const char * name() { return "boost::variant"; }
+};
+
+struct variant2_adapter : adapter<geometry_collection2, point, linestring>
+{
+    static const char * name() { return "boost::variant2"; }
+};
+
+struct any_adapter : adapter<any_collection, point, linestring>
+{
+    static const char * name() { return "boost::any"; }
+};
+
+struct my_geometry_adapter : adapter<MyGColl, MyPoint, MyLinestring>
+{
+    static const char * name() { return "MyGColl"; }
+};
+
+struct my_geometry1_adapter : adapter<MyGColl1, MyPoint1, MyLinestring1>
+{
+    static const char * name() { return "MyGeometry1"; }
+};
+
+struct my_geometry2_adapter : adapter<MyGColl2, MyPoint2, MyLinestring2>
+{
+    static const char * name() { return "MyGeometry2"; }
+};
+
+struct arena_adapter : adapter<arena_collection, point, arena_linestring>
+{
+    static const char * name() { return "arena"; }
+};
+
+struct flat_adapter : adapter<bg::model::flat_geometry_collection<point>, point, bg::model::flat_linestring<point>>
+{
+    static const char * name() { return "flat"; }
+};
+
+struct soa_adapter : adapter<soa_collection, point, linestring>
+{
+    static const char * name() { return "soa"; }
+    static const bool nesting = false;
+};
+
+
+// Generators
+
+// Deterministic, so every adapter gets the same sequence of types
+struct generator
+{
+    std::size_t next()
+    {
+        m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<std::size_t>(m_state >> 33);
+    }
+
+    unsigned long long m_state = 1;
+};
+
+template <typename Adapter>
+void emplace_back_leaf(typename Adapter::gc_t & gc, generator & gen)
+{
+    std::size_t const r = gen.next();
+    double const x = double(r % 1000);
+    double const y = double(r / 1000 % 1000);
+
+    typename Adapter::point_t pt;
+    bg::set<0>(pt, x);
+    bg::set<1>(pt, y);
+
+    if (r % 3 == 0)
+    {
+        typename Adapter::linestring_t ls;
+        bg::append(ls, pt);
+        bg::set<0>(pt, x + 1);
+        bg::append(ls, pt);
+        bg::range::emplace_back(gc, std::move(ls));
+    }
+    else
+    {
+        bg::range::emplace_back(gc, std::move(pt));
+    }
+}
+
+template <typename Adapter>
+void fill_flat(typename Adapter::gc_t & gc, std::size_t count, generator & gen)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        emplace_back_leaf<Adapter>(gc, gen);
+    }
+}
+
+// Every collection holds leaves_per_level leaves and fanout nested collections
+// down to the given depth.
+template <typename Adapter>
+std::size_t fill_nested(typename Adapter::gc_t & gc, std::size_t depth, generator & gen)
+{
+    static const std::size_t leaves_per_level = 12;
+    static const std::size_t fanout = 4;
+
+    fill_flat<Adapter>(gc, leaves_per_level, gen);
+    std::size_t count = leaves_per_level;
+    if (depth > 0)
+    {
+        for (std::size_t i = 0; i < fanout; ++i)
+        {
+            typename Adapter::gc_t child;
+            count += fill_nested<Adapter>(child, depth - 1, gen);
+            bg::range::emplace_back(gc, std::move(child));
+        }
+    }
+    return count;
+}
+
+
+// Visitors
+
+struct num_points_visitor
+{
+    template <typename Geometry, std::enable_if_t<! bg::util::is_geometry_collection<Geometry>::value, int> = 0>
+    void operator()(Geometry const& g)
+    {
+        m_count += bg::num_points(g);
+    }
+
+    template <typename Geometry, std::enable_if_t<bg::util::is_geometry_collection<Geometry>::value, int> = 0>
+    void operator()(Geometry const& g)
+    {
+        m_count += boost::size(g);
+    }
+
+    template <typename Geometry1, typename Geometry2>
+    void operator()(Geometry1 const& g1, Geometry2 const& g2)
+    {
+        (*this)(g1);
+        (*this)(g2);
+    }
+
+    std::size_t m_count = 0;
+};
+
+// Per-element visit, elements of e.g. MyGColl are not DynamicGeometries
+// so they can only be visited through the collection.
+template
+<
+    typename GeometryCollection,
+    bool IsDynamic = bg::util::is_dynamic_geometry
+        <
+            typename boost::range_value<GeometryCollection>::type
+        >::value
+>
+struct element_visit
+{
+    static const bool dynamic = true;
+
+    template <typename Function, typename Iterator>
+    static void apply(Function & function, Iterator it)
+    {
+        bg::visit(function, *it);
+    }
+
+    template <typename Function, typename Iterator>
+    static void apply(Function & function, Iterator it1, Iterator it2)
+    {
+        bg::visit(function, *it1, *it2);
+    }
+
+    // Two 1-parameter visits, for comparison with 2-parameter visit
+    template <typename Function, typename Iterator>
+    static void apply_nested(Function & function, Iterator it1, Iterator it2)
+    {
+        bg::visit([&](auto & g1)
+        {
+            bg::visit([&](auto & g2) { function(g1, g2); }, *it2);
+        }, *it1);
+    }
+};
+
+template <typename GeometryCollection>
+struct element_visit<GeometryCollection, false>
+{
+    static const bool dynamic = false;
+
+    template <typename Function, typename Iterator>
+    static void apply(Function & function, Iterator it)
+    {
+        bg::traits::visit_iterator<GeometryCollection>::apply(function, it);
+    }
+
+    template <typename Function, typename Iterator>
+    static void apply(Function & , Iterator , Iterator )
+    {}
+
+    template <typename Function, typename Iterator>
+    static void apply_nested(Function & , Iterator , Iterator )
+    {}
+};
+
+
+// Measurement
+
+struct result
+{
+    double ns_per_element;
+    double branch_misses_per_element;
+    double allocations_per_run;
+};
+
+template <typename Run>
+result measure(std::size_t elements, std::size_t repeats, Run && run)
+{
+    branch_misses_counter counter;
+
+    double best_ns = -1;
+    long long best_misses = 0;
+    std::size_t allocations = 0;
+    std::size_t checksum = 0;
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        std::size_t const allocations_before = allocation_count.load();
+        counter.start();
+        auto const start = std::chrono::steady_clock::now();
+
+        checksum += run();
+
+        auto const finish = std::chrono::steady_clock::now();
+        long long const misses = counter.stop();
+        allocations += allocation_count.load() - allocations_before;
+
+        double const ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+        if (best_ns < 0 || ns < best_ns)
+        {
+            best_ns = ns;
+            best_misses = misses;
+        }
+    }
+
+    // Prevent the optimizer from removing the traversals
+    if (checksum == std::size_t(-1))
+    {
+        std::cerr << checksum;
+    }
+
+    result res;
+    res.ns_per_element = best_ns / double(elements);
+    res.branch_misses_per_element = counter.available() ? double(best_misses) / double(elements) : -1;
+    res.allocations_per_run = double(allocations) / double(repeats);
+    return res;
+}
+
+void print_header()
+{
+    std::cout << std::left
+              << std::setw(18) << "adapter"
+              << std::setw(28) << "benchmark"
+              << std::right
+              << std::setw(12) << "ns/elem"
+              << std::setw(16) << "br-miss/elem"
+              << std::setw(14) << "allocs/run"
+              << std::endl;
+}
+
+void print_result(const char * adapter_name, const char * benchmark_name, result const& res)
+{
+    std::cout << std::left
+              << std::setw(18) << adapter_name
+              << std::setw(28) << benchmark_name
+              << std::right << std::fixed
+              << std::setw(12) << std::setprecision(2) << res.ns_per_element;
+    if (res.branch_misses_per_element >= 0)
+    {
+        std::cout << std::setw(16) << std::setprecision(4) << res.branch_misses_per_element;
+    }
+    else
+    {
+        std::cout << std::setw(16) << "n/a";
+    }
+    std::cout << std::setw(14) << std::setprecision(1) << res.allocations_per_run
+              << std::endl;
+}
+
+template <typename Adapter, typename GeometryCollection>
+void run_traversal_benchmarks(GeometryCollection const& gc, std::size_t elements,
+                              const char * kind, std::size_t repeats)
+{
+    std::string const suffix = std::string(" (") + kind + ")";
+
+    print_result(Adapter::name(), ("visit_breadth_first" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_breadth_first([&](auto const& g) { visitor(g); }, gc);
+            return visitor.m_count;
+        }));
+
+    print_result(Adapter::name(), ("visit_depth_first" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_depth_first([&](auto const& g) { visitor(g); }, gc);
+            return visitor.m_count;
+        }));
+
+    print_result(Adapter::name(), ("visit_grouped" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_grouped([&](auto const& range)
+            {
+                for (auto const& g : range)
+                {
+                    visitor(g);
+                }
+            }, gc);
+            return visitor.m_count;
+        }));
+
+    print_result(Adapter::name(), ("envelope" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            auto const box = bg::return_envelope<bg::model::box<typename Adapter::point_t>>(gc);
+            return std::size_t(bg::get<bg::max_corner, 0>(box));
+        }));
+
+    print_result(Adapter::name(), ("num_points" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            return bg::num_points(gc);
+        }));
+
+    print_result(Adapter::name(), ("length depth_first" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            double result = 0;
+            bg::visit_depth_first([&](auto const& g)
+            {
+                result += double(bg::length(g));
+            }, gc);
+            return std::size_t(result);
+        }));
+
+    print_result(Adapter::name(), ("length" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            return std::size_t(bg::length(gc));
+        }));
+
+    typename Adapter::point_t pt;
+    bg::set<0>(pt, 500.5);
+    bg::set<1>(pt, 500.5);
+
+    print_result(Adapter::name(), ("distance scan" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            double result = std::numeric_limits<double>::max();
+            bg::visit_depth_first([&](auto const& g)
+            {
+                result = (std::min)(result, double(bg::distance(pt, g)));
+            }, gc);
+            return std::size_t(result * 1000);
+        }));
+
+    print_result(Adapter::name(), ("distance" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            return std::size_t(bg::distance(pt, gc) * 1000);
+        }));
+
+    // The rtree is built once and only the query is measured
+    bg::index::collection_rtree<GeometryCollection const> const rtree(gc);
+    print_result(Adapter::name(), ("distance rtree" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            return std::size_t(bg::index::distance(pt, rtree) * 1000);
+        }));
+
+    print_result(Adapter::name(), ("intersects scan" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            bool result = false;
+            bg::visit_depth_first([&](auto const& g)
+            {
+                result = bg::intersects(pt, g) || result;
+            }, gc);
+            return std::size_t(result);
+        }));
+
+    print_result(Adapter::name(), ("intersects" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            return std::size_t(bg::intersects(pt, gc));
+        }));
+
+    print_result(Adapter::name(), ("visit_parallel" + suffix).c_str(),
+        measure(elements, repeats, [&]()
+        {
+            std::size_t count = 0;
+            for (auto const& visitor : bg::visit_parallel(num_points_visitor(), gc).first)
+            {
+                count += visitor.m_count;
+            }
+            return count;
+        }));
+}
+
+template <typename Adapter, std::enable_if_t<Adapter::nesting, int> = 0>
+void run_nested_benchmarks(std::size_t depth, std::size_t repeats)
+{
+    generator gen;
+    typename Adapter::gc_t nested;
+    std::size_t const nested_elements = fill_nested<Adapter>(nested, depth, gen);
+    run_traversal_benchmarks<Adapter>(nested, nested_elements, "nest", repeats);
+}
+
+template <typename Adapter, std::enable_if_t<! Adapter::nesting, int> = 0>
+void run_nested_benchmarks(std::size_t , std::size_t )
+{}
+
+template <typename Adapter>
+void run_benchmarks(std::size_t elements, std::size_t depth, std::size_t repeats)
+{
+    using gc_t = typename Adapter::gc_t;
+
+    generator gen;
+
+    gc_t flat;
+    fill_flat<Adapter>(flat, elements, gen);
+    gc_t const& cflat = flat;
+
+    print_result(Adapter::name(), "visit (flat)",
+        measure(elements, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            for (auto it = boost::begin(cflat); it != boost::end(cflat); ++it)
+            {
+                element_visit<gc_t>::apply(visitor, it);
+            }
+            return visitor.m_count;
+        }));
+
+    if (element_visit<gc_t>::dynamic)
+    {
+        print_result(Adapter::name(), "visit_two (flat)",
+            measure(elements, repeats, [&]()
+            {
+                num_points_visitor visitor;
+                auto it = boost::begin(cflat);
+                auto const end = boost::end(cflat);
+                if (it != end)
+                {
+                    for (auto next = it + 1; next != end; ++it, ++next)
+                    {
+                        element_visit<gc_t>::apply(visitor, it, next);
+                    }
+                }
+                return visitor.m_count;
+            }));
+
+        print_result(Adapter::name(), "visit_two nested (flat)",
+            measure(elements, repeats, [&]()
+            {
+                num_points_visitor visitor;
+                auto it = boost::begin(cflat);
+                auto const end = boost::end(cflat);
+                if (it != end)
+                {
+                    for (auto next = it + 1; next != end; ++it, ++next)
+                    {
+                        element_visit<gc_t>::apply_nested(visitor, it, next);
+                    }
+                }
+                return visitor.m_count;
+            }));
+    }
+    else
+    {
+        std::cout << std::left << std::setw(18) << Adapter::name()
+                  << std::setw(28) << "visit_two (flat)" << "not supported" << std::endl;
+    }
+
+    run_traversal_benchmarks<Adapter>(cflat, elements, "flat", repeats);
+    run_nested_benchmarks<Adapter>(depth, repeats);
+}
+
+// Compares building and destroying nested collections with and without an arena
+void run_build_benchmarks(std::size_t depth, std::size_t repeats)
+{
+    std::size_t elements = 0;
+    {
+        generator gen;
+        geometry_collection1 gc;
+        elements = fill_nested<variant_adapter>(gc, depth, gen);
+    }
+
+    print_result(variant_adapter::name(), "build (nest)",
+        measure(elements, repeats, [&]()
+        {
+            generator gen;
+            geometry_collection1 gc;
+            return fill_nested<variant_adapter>(gc, depth, gen);
+        }));
+
+    bg::model::monotonic_arena arena;
+    print_result(arena_adapter::name(), "build (nest)",
+        measure(elements, repeats, [&]()
+        {
+            std::size_t count = 0;
+            {
+                bg::model::arena_scope scope(arena);
+                generator gen;
+                arena_collection gc;
+                count = fill_nested<arena_adapter>(gc, depth, gen);
+            }
+            arena.reset();
+            return count;
+        }));
+}
+
+// Compares copying linestrings one by one into a collection with moving them
+// with one append
+template <typename Adapter>
+void run_append_benchmark(std::size_t elements, std::size_t repeats)
+{
+    using linestring_t = typename Adapter::linestring_t;
+
+    auto const make_linestrings = [&]()
+    {
+        std::vector<linestring_t> result(elements);
+        for (std::size_t i = 0; i < elements; ++i)
+        {
+            typename Adapter::point_t pt;
+            bg::set<0>(pt, double(i));
+            for (std::size_t j = 0; j < 8; ++j)
+            {
+                bg::set<1>(pt, double(j));
+                bg::append(result[i], pt);
+            }
+        }
+        return result;
+    };
+
+    print_result(Adapter::name(), "build copy (flat)",
+        measure(elements, repeats, [&]()
+        {
+            std::vector<linestring_t> const linestrings = make_linestrings();
+            typename Adapter::gc_t gc;
+            for (linestring_t const& ls : linestrings)
+            {
+                bg::range::emplace_back(gc, ls);
+            }
+            return std::size_t(boost::size(gc));
+        }));
+
+    print_result(Adapter::name(), "build append (flat)",
+        measure(elements, repeats, [&]()
+        {
+            std::vector<linestring_t> linestrings = make_linestrings();
+            typename Adapter::gc_t gc;
+            bg::range::append(gc, std::make_move_iterator(linestrings.begin()),
+                              std::make_move_iterator(linestrings.end()));
+            return std::size_t(boost::size(gc));
+        }));
+}
+
+void run_append_benchmarks(std::size_t elements, std::size_t repeats)
+{
+    run_append_benchmark<variant_adapter>(elements, repeats);
+    run_append_benchmark<any_adapter>(elements, repeats);
+    run_append_benchmark<my_geometry_adapter>(elements, repeats);
+}
+
+// Reads a collection of leaves from WKT held in memory and in a stream,
+// writes and reads it as WKB and views it in WKB
+void run_read_benchmarks(std::size_t elements, std::size_t repeats)
+{
+    generator gen;
+    geometry_collection1 flat;
+    fill_flat<variant_adapter>(flat, elements, gen);
+
+    std::ostringstream out;
+    const char * separator = "GEOMETRYCOLLECTION(";
+    bg::visit_depth_first([&](auto const& g)
+    {
+        out << separator << bg::wkt(g);
+        separator = ",";
+    }, flat);
+    out << ")";
+    std::string const wkt = out.str();
+
+    print_result(variant_adapter::name(), "read_wkt string (flat)",
+        measure(elements, repeats, [&]()
+        {
+            geometry_collection1 gc;
+            bg::read_wkt(wkt, gc);
+            return boost::size(gc);
+        }));
+
+    print_result(variant_adapter::name(), "read_wkt stream (flat)",
+        measure(elements, repeats, [&]()
+        {
+            std::istringstream stream(wkt);
+            geometry_collection1 gc;
+            bg::read_wkt(stream, gc);
+            return boost::size(gc);
+        }));
+
+    std::vector<std::uint8_t> wkb;
+    print_result(variant_adapter::name(), "write_wkb (flat)",
+        measure(elements, repeats, [&]()
+        {
+            wkb.clear();
+            bg::write_wkb(flat, wkb);
+            return wkb.size();
+        }));
+
+    print_result(variant_adapter::name(), "read_wkb (flat)",
+        measure(elements, repeats, [&]()
+        {
+            geometry_collection1 gc;
+            bg::read_wkb(wkb.data(), wkb.data() + wkb.size(), gc);
+            return boost::size(gc);
+        }));
+
+    // Points of all elements counted after reading and in place
+    print_result(variant_adapter::name(), "read_wkb num_points (flat)",
+        measure(elements, repeats, [&]()
+        {
+            geometry_collection1 gc;
+            bg::read_wkb(wkb.data(), wkb.data() + wkb.size(), gc);
+            std::size_t count = 0;
+            bg::visit_depth_first([&](auto const& g) { count += bg::num_points(g); }, gc);
+            return count;
+        }));
+
+    print_result("wkb_view", "num_points (flat)",
+        measure(elements, repeats, [&]()
+        {
+            bg::model::wkb_view<point> const view(wkb.data(), wkb.data() + wkb.size());
+            std::size_t count = 0;
+            bg::visit_depth_first([&](auto const& g) { count += bg::num_points(g); }, view);
+            return count;
+        }));
+}
+
+// Traverses collections compiled from boost::variant collections
+void run_flat_benchmarks(std::size_t elements, std::size_t depth, std::size_t repeats)
+{
+    generator gen;
+    geometry_collection1 flat;
+    fill_flat<variant_adapter>(flat, elements, gen);
+    geometry_collection1 nested;
+    std::size_t const nested_elements = fill_nested<variant_adapter>(nested, depth, gen);
+
+    using cached_t = bg::model::cached_envelope_collection<geometry_collection1, bg::model::box<point>>;
+    cached_t const cached(nested);
+    print_result("cached", "envelope (nest)",
+        measure(nested_elements, repeats, [&]()
+        {
+            auto const box = bg::return_envelope<bg::model::box<point>>(cached);
+            return std::size_t(bg::get<bg::max_corner, 0>(box));
+        }));
+
+    print_result(flat_adapter::name(), "build (nest)",
+        measure(nested_elements, repeats, [&]()
+        {
+            return bg::model::flat_geometry_collection<point>(nested).num_nodes();
+        }));
+
+    run_traversal_benchmarks<flat_adapter>(bg::model::flat_geometry_collection<point>(flat),
+                                           elements, "flat", repeats);
+    run_traversal_benchmarks<flat_adapter>(bg::model::flat_geometry_collection<point>(nested),
+                                           nested_elements, "nest", repeats);
+}
+
+// Compares filtering a nested collection by a box with a scan and with an rtree
+void run_rtree_benchmarks(std::size_t depth, std::size_t repeats)
+{
+    using box = bg::model::box<point>;
+    using rtree_t = bg::index::collection_rtree<geometry_collection1 const>;
+
+    generator gen;
+    geometry_collection1 nested;
+    std::size_t const elements = fill_nested<variant_adapter>(nested, depth, gen);
+    geometry_collection1 const& cnested = nested;
+    box const query_box(point(100, 100), point(200, 200));
+
+    print_result(variant_adapter::name(), "box scan (nest)",
+        measure(elements, repeats, [&]()
+        {
+            std::size_t count = 0;
+            bg::visit_depth_first([&](auto const& g)
+            {
+                if (bg::intersects(bg::return_envelope<box>(g), query_box))
+                {
+                    ++count;
+                }
+            }, cnested);
+            return count;
+        }));
+
+    print_result(variant_adapter::name(), "rtree build (nest)",
+        measure(elements, repeats, [&]()
+        {
+            return rtree_t(cnested).size();
+        }));
+
+    rtree_t const rtree(cnested);
+    print_result(variant_adapter::name(), "rtree query (nest)",
+        measure(elements, repeats, [&]()
+        {
+            std::size_t count = 0;
+            rtree.query(bg::index::intersects(query_box), [&](auto const& ) { ++count; });
+            return count;
+        }));
+}
+
+// Compares visiting all pairs of elements of two nested collections with nested
+// traversals and with visit_pairwise, times are per pair of elements
+void run_pairwise_benchmarks(std::size_t depth, std::size_t repeats)
+{
+    generator gen;
+    geometry_collection1 nested1;
+    std::size_t const elements1 = fill_nested<variant_adapter>(nested1, depth, gen);
+    geometry_collection1 nested2;
+    std::size_t const elements2 = fill_nested<variant_adapter>(nested2, depth, gen);
+    geometry_collection1 const& cnested1 = nested1;
+    geometry_collection1 const& cnested2 = nested2;
+    std::size_t const pairs = elements1 * elements2;
+
+    print_result(variant_adapter::name(), "nested traversals (pairs)",
+        measure(pairs, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_depth_first([&](auto const& g1)
+            {
+                bg::visit_depth_first([&](auto const& g2) { visitor(g1, g2); }, cnested2);
+            }, cnested1);
+            return visitor.m_count;
+        }));
+
+    print_result(variant_adapter::name(), "pairwise none (pairs)",
+        measure(pairs, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_pairwise([&](auto const& g1, auto const& g2) { visitor(g1, g2); },
+                               cnested1, cnested2, bg::pairwise_pruning::none);
+            return visitor.m_count;
+        }));
+
+    print_result(variant_adapter::name(), "pairwise sweep (pairs)",
+        measure(pairs, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_pairwise([&](auto const& g1, auto const& g2) { visitor(g1, g2); },
+                               cnested1, cnested2, bg::pairwise_pruning::sweep);
+            return visitor.m_count;
+        }));
+
+    print_result(variant_adapter::name(), "pairwise rtree (pairs)",
+        measure(pairs, repeats, [&]()
+        {
+            num_points_visitor visitor;
+            bg::visit_pairwise([&](auto const& g1, auto const& g2) { visitor(g1, g2); },
+                               cnested1, cnested2, bg::pairwise_pruning::rtree);
+            return visitor.m_count;
+        }));
+
+    print_result(variant_adapter::name(), "pairwise parallel (pairs)",
+        measure(pairs, repeats, [&]()
+        {
+            std::size_t count = 0;
+            for (auto const& visitor : bg::visit_pairwise_parallel(num_points_visitor(), cnested1, cnested2).first)
+            {
+                count += visitor.m_count;
+            }
+            return count;
+        }));
+}
+
+// Multi-geometries are stored at the end of geometry_types
+void fill_flat_multi(any_collection & gc, std::size_t count, generator & gen)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::size_t const r = gen.next();
+        point const pt(double(r % 1000), double(r / 1000 % 1000));
+        if (r % 3 == 0)
+        {
+            mlinestring mls;
+            mls.resize(1);
+            bg::append(mls[0], pt);
+            bg::append(mls[0], pt);
+            bg::range::emplace_back(gc, std::move(mls));
+        }
+        else
+        {
+            mpoint mpt;
+            bg::append(mpt, pt);
+            bg::range::emplace_back(gc, std::move(mpt));
+        }
+    }
+}
+
+struct any_binary_split
+{
+    template <typename Function, typename Any>
+    static void apply(Function & function, Any & any)
+    {
+        using types_t = bg::traits::geometry_types<boost::any>::type;
+        bg::traits::visit_boost_any<types_t>::apply<0>(function, any);
+    }
+};
+
+struct any_table
+{
+    template <typename Function, typename Any>
+    static void apply(Function & function, Any & any)
+    {
+        using types_t = bg::traits::geometry_types<boost::any>::type;
+        bg::traits::visit_boost_any_table<types_t>::apply(function, any);
+    }
+};
+
+template <typename Dispatch>
+void run_any_dispatch_benchmark(const char * benchmark_name, any_collection const& gc, std::size_t repeats)
+{
+    print_result(any_adapter::name(), benchmark_name,
+        measure(boost::size(gc), repeats, [&]()
+        {
+            num_points_visitor visitor;
+            for (auto const& any : gc)
+            {
+                Dispatch::apply(visitor, any);
+            }
+            return visitor.m_count;
+        }));
+}
+
+// Compares the dispatch modes available for boost::any
+void run_any_dispatch_benchmarks(std::size_t elements, std::size_t repeats)
+{
+    generator gen;
+    any_collection front;
+    fill_flat<any_adapter>(front, elements, gen);
+    any_collection back;
+    fill_flat_multi(back, elements, gen);
+
+    run_any_dispatch_benchmark<any_binary_split>("binary split (front types)", front, repeats);
+    run_any_dispatch_benchmark<any_table>("table (front types)", front, repeats);
+    run_any_dispatch_benchmark<any_binary_split>("binary split (back types)", back, repeats);
+    run_any_dispatch_benchmark<any_table>("table (back types)", back, repeats);
+}
+
+// Usage: benchmark [elements] [depth] [repeats]
+int main(int argc, char ** argv)
+{
+    std::size_t const elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::size_t const depth = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8;
+    std::size_t const repeats = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    std::cout << "elements: " << elements << ", nesting depth: " << depth
+              << ", repeats: " << repeats << std::endl;
+
+    print_header();
+    run_benchmarks<variant_adapter>(elements, depth, repeats);
+    run_build_benchmarks(depth, repeats);
+    run_append_benchmarks(elements, repeats);
+    run_read_benchmarks(elements, repeats);
+    run_rtree_benchmarks(depth, repeats);
+    run_pairwise_benchmarks(depth / 2, repeats);
+    run_benchmarks<variant2_adapter>(elements, depth, repeats);
+    run_benchmarks<any_adapter>(elements, depth, repeats);
+    run_any_dispatch_benchmarks(elements, repeats);
+    run_benchmarks<my_geometry_adapter>(elements, depth, repeats);
+    run_benchmarks<my_geometry1_adapter>(elements, depth, repeats);
+    run_benchmarks<my_geometry2_adapter>(elements, depth, repeats);
+    run_benchmarks<soa_adapter>(elements, depth, repeats);
+    run_flat_benchmarks(elements, depth, repeats);
+
+    return 0;
+}
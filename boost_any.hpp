@@ -1,6 +1,10 @@
 #ifndef BOOST_ANY_HPP
 #define BOOST_ANY_HPP
 
+#include <cstdint>
+#include <typeinfo>
+#include <utility>
+
 #include <boost/any.hpp>
 
 #include "geometry.hpp"
@@ -21,7 +25,7 @@ struct visit_boost_any
     static const std::size_t M = N / 2;
 
     template <std::size_t Offset, typename Function, typename Any>
-    static bool apply(Function function, Any & any)
+    static bool apply(Function & function, Any & any)
     {
         return visit_boost_any<TypeSequence, M>::template apply<Offset>(function, any)
             || visit_boost_any<TypeSequence, N - M>::template apply<Offset + M>(function, any);
@@ -32,7 +36,7 @@ template <typename TypeSequence>
 struct visit_boost_any<TypeSequence, 1>
 {
     template <std::size_t Offset, typename Function, typename Any>
-    static bool apply(Function function, Any & any)
+    static bool apply(Function & function, Any & any)
     {
         using elem_t = typename util::sequence_element<Offset, TypeSequence>::type;
         using geom_t = util::transcribe_const_t<Any, elem_t>;
@@ -53,20 +57,177 @@ template <typename TypeSequence>
 struct visit_boost_any<TypeSequence, 0>
 {
     template <std::size_t Offset, typename Function, typename Any>
-    static bool apply(Function , Any & )
+    static bool apply(Function & , Any & )
+    {
+        return false;
+    }
+};
+
+// Maps the type stored in boost::any to its index in TypeSequence or returns the size
+// of TypeSequence if the type is not there. The addresses of type_info objects are hashed
+// so the cost of the lookup doesn't depend on the number or order of types. The addresses
+// are not guaranteed to be unique, e.g. across shared libraries, so if the address is not
+// found the type_infos are compared as a fallback.
+template <typename TypeSequence>
+struct boost_any_type_index
+{
+    static const std::size_t N = util::sequence_size<TypeSequence>::value;
+
+    static std::size_t apply(std::type_info const& type)
+    {
+        table const& t = get_table();
+        for (std::size_t i = hash(&type) & table::mask; t.entries[i].type != nullptr; i = (i + 1) & table::mask)
+        {
+            if (t.entries[i].type == &type)
+            {
+                return t.entries[i].index;
+            }
+        }
+
+        for (std::size_t i = 0; i < table::size; ++i)
+        {
+            if (t.entries[i].type != nullptr && *t.entries[i].type == type)
+            {
+                return t.entries[i].index;
+            }
+        }
+
+        return N;
+    }
+
+private:
+    static constexpr std::size_t next_power_of_two(std::size_t n, std::size_t result = 1)
+    {
+        return result >= n ? result : next_power_of_two(n, result * 2);
+    }
+
+    struct table
+    {
+        // Power of 2, at least half empty
+        static const std::size_t size = next_power_of_two(2 * N);
+        static const std::size_t mask = size - 1;
+
+        struct entry
+        {
+            std::type_info const* type = nullptr;
+            std::size_t index = 0;
+        };
+
+        template <std::size_t ...Is>
+        table(std::index_sequence<Is...>)
+        {
+            std::type_info const* types[] = { &typeid(typename util::sequence_element<Is, TypeSequence>::type)... };
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                std::size_t i = hash(types[j]) & mask;
+                while (entries[i].type != nullptr && entries[i].type != types[j])
+                {
+                    i = (i + 1) & mask;
+                }
+                // In case of duplicates the first index is used
+                if (entries[i].type == nullptr)
+                {
+                    entries[i].type = types[j];
+                    entries[i].index = j;
+                }
+            }
+        }
+
+        entry entries[size];
+    };
+
+    static std::size_t hash(std::type_info const* type)
+    {
+        return geometry::detail::visit_table::type_info_hash(type);
+    }
+
+    static table const& get_table()
+    {
+        static const table t(std::make_index_sequence<N>{});
+        return t;
+    }
+};
+
+// Looks up the index of the stored type once and calls the function through a table
+// of handlers, so the cost is the same for all types in TypeSequence.
+template
+<
+    typename TypeSequence,
+    typename IndexSequence = std::make_index_sequence<util::sequence_size<TypeSequence>::value>
+>
+struct visit_boost_any_table
+{
+    template <typename Function, typename Any>
+    static bool apply(Function & , Any & )
     {
         return false;
     }
 };
 
+template <typename TypeSequence, std::size_t I, std::size_t ...Is>
+struct visit_boost_any_table<TypeSequence, std::index_sequence<I, Is...>>
+{
+    template <typename Function, typename Any>
+    static bool apply(Function & function, Any & any)
+    {
+        using handler_t = void (*)(Function &, Any &);
+        static const handler_t handlers[] = { &call<I, Function, Any>, &call<Is, Function, Any>... };
+
+        std::size_t const index = boost_any_type_index<TypeSequence>::apply(any.type());
+        if (index >= 1 + sizeof...(Is))
+        {
+            return false;
+        }
+
+        handlers[index](function, any);
+        return true;
+    }
+
+private:
+    template <std::size_t Index, typename Function, typename Any>
+    static void call(Function & function, Any & any)
+    {
+        using elem_t = typename util::sequence_element<Index, TypeSequence>::type;
+        function(*boost::unsafe_any_cast<elem_t>(boost::addressof(any)));
+    }
+};
+
+// By default the table is used. Define BOOST_GEOMETRY_BOOST_ANY_BINARY_DISPATCH
+// to use the binary split over geometry_types instead.
 template <>
 struct visit<boost::any>
 {
     template <typename Function, typename Any>
-    static void apply(Function function, Any & any)
+    static void apply(Function && function, Any & any)
     {
         using types_t = typename geometry_types<std::remove_const_t<Any>>::type;
+#ifdef BOOST_GEOMETRY_BOOST_ANY_BINARY_DISPATCH
         visit_boost_any<types_t>::template apply<0>(function, any);
+#else
+        visit_boost_any_table<types_t>::apply(function, any);
+#endif
+    }
+};
+
+template <>
+struct which<boost::any>
+{
+    template <typename Any>
+    static std::size_t apply(Any const& any)
+    {
+        using types_t = typename geometry_types<Any>::type;
+        return boost_any_type_index<types_t>::apply(any.type());
+    }
+};
+
+template <>
+struct unsafe_get<boost::any>
+{
+    template <std::size_t I, typename Any>
+    static auto & apply(Any & any)
+    {
+        using elem_t = typename util::sequence_element<I, typename geometry_types<std::remove_const_t<Any>>::type>::type;
+        return *boost::unsafe_any_cast<elem_t>(boost::addressof(any));
     }
 };
 
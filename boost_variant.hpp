@@ -16,26 +16,27 @@ struct tag<boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)>>
 template <BOOST_VARIANT_ENUM_PARAMS(typename T)>
 struct visit<boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)>>
 {
+    // The function is kept by reference so it's not copied
     template <typename Function>
     struct visitor : boost::static_visitor<>
     {
-        visitor(Function function)
+        explicit visitor(Function & function)
             : m_function(function)
         {}
 
         template <typename Geometry>
-        void operator()(Geometry & geometry)
+        void operator()(Geometry & geometry) const
         {
             m_function(geometry);
         }
 
-        Function m_function;
+        Function & m_function;
     };
 
     template <typename Function, typename Variant>
-    static void apply(Function function, Variant & variant)
+    static void apply(Function && function, Variant & variant)
     {
-        visitor<Function> visitor(function);
+        visitor<std::remove_reference_t<Function>> const visitor(function);
         boost::apply_visitor(visitor, variant);
     }
 };
@@ -46,23 +47,23 @@ struct visit<boost::variant<BOOST_VARIANT_ENUM_PARAMS(T)>, boost::variant<BOOST_
     template <typename Function>
     struct visitor : boost::static_visitor<>
     {
-        visitor(Function function)
+        explicit visitor(Function & function)
             : m_function(function)
         {}
 
         template <typename Geometry1, typename Geometry2>
-        void operator()(Geometry1 & geometry1, Geometry2 & geometry2)
+        void operator()(Geometry1 & geometry1, Geometry2 & geometry2) const
         {
             m_function(geometry1, geometry2);
         }
 
-        Function m_function;
+        Function & m_function;
     };
 
     template <typename Function, typename Variant1, typename Variant2>
-    static void apply(Function function, Variant1 & variant1, Variant2 & variant2)
+    static void apply(Function && function, Variant1 & variant1, Variant2 & variant2)
     {
-        visitor<Function> visitor(function);
+        visitor<std::remove_reference_t<Function>> const visitor(function);
         boost::apply_visitor(visitor, variant1, variant2);
     }
 };
@@ -0,0 +1,148 @@
+#ifndef CACHED_ENVELOPE_COLLECTION_HPP
+#define CACHED_ENVELOPE_COLLECTION_HPP
+
+#include <utility>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/size.hpp>
+
+#include "envelope.hpp"
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace model {
+
+// GeometryCollection calculating its envelope once and keeping it until the
+// collection is modified. The envelope is expanded by Geometries added with
+// emplace_back and recalculated after clear.
+// NOTE: The envelope is calculated with the default strategy. If the envelope of
+//   a different Box type is requested it is calculated from scratch.
+// NOTE: If the elements are modified in place invalidate() has to be called.
+template <typename GeometryCollection, typename Box>
+class cached_envelope_collection
+{
+public:
+    using value_type = typename boost::range_value<GeometryCollection>::type;
+    using size_type = typename boost::range_size<GeometryCollection>::type;
+    using iterator = typename boost::range_iterator<GeometryCollection>::type;
+    using const_iterator = typename boost::range_iterator<GeometryCollection const>::type;
+
+    cached_envelope_collection() = default;
+
+    explicit cached_envelope_collection(GeometryCollection const& collection)
+        : m_collection(collection)
+    {}
+
+    explicit cached_envelope_collection(GeometryCollection && collection)
+        : m_collection(std::move(collection))
+    {}
+
+    iterator begin() { return boost::begin(m_collection); }
+    iterator end() { return boost::end(m_collection); }
+    const_iterator begin() const { return boost::begin(m_collection); }
+    const_iterator end() const { return boost::end(m_collection); }
+
+    size_type size() const { return boost::size(m_collection); }
+    bool empty() const { return boost::empty(m_collection); }
+
+    GeometryCollection const& base() const
+    {
+        return m_collection;
+    }
+
+    Box const& envelope() const
+    {
+        if (! m_valid)
+        {
+            geometry::envelope(m_collection, m_envelope);
+            m_valid = true;
+        }
+        return m_envelope;
+    }
+
+    void invalidate()
+    {
+        m_valid = false;
+    }
+
+    template <typename Geometry>
+    void emplace_back(Geometry && element)
+    {
+        if (! m_valid || geometry::is_empty(element))
+        {
+            range::emplace_back(m_collection, std::forward<Geometry>(element));
+            return;
+        }
+
+        Box expanded;
+        geometry::envelope(element, expanded);
+        if (! geometry::is_empty(m_collection))
+        {
+            geometry::expand(expanded, m_envelope);
+        }
+        range::emplace_back(m_collection, std::forward<Geometry>(element));
+        m_envelope = expanded;
+    }
+
+    void clear()
+    {
+        geometry::clear(m_collection);
+        m_valid = false;
+    }
+
+private:
+    GeometryCollection m_collection;
+    mutable Box m_envelope;
+    mutable bool m_valid = false;
+};
+
+} // namespace model
+
+namespace traits {
+
+template <typename GeometryCollection, typename Box>
+struct tag<model::cached_envelope_collection<GeometryCollection, Box>>
+{
+    typedef geometry_collection_tag type;
+};
+
+template <typename GeometryCollection, typename Box>
+struct geometry_types<model::cached_envelope_collection<GeometryCollection, Box>>
+    : geometry_types<GeometryCollection>
+{};
+
+template <typename GeometryCollection, typename Box>
+struct visit_iterator<model::cached_envelope_collection<GeometryCollection, Box>>
+    : visit_iterator<GeometryCollection>
+{};
+
+} // namespace traits
+
+namespace dispatch
+{
+
+template <typename GeometryCollection, typename Box>
+struct envelope<model::cached_envelope_collection<GeometryCollection, Box>, geometry_collection_tag>
+{
+    template <typename Strategy>
+    static inline void apply(model::cached_envelope_collection<GeometryCollection, Box> const& geometry,
+                             Box & mbr, Strategy const& )
+    {
+        mbr = geometry.envelope();
+    }
+
+    template <typename OtherBox, typename Strategy>
+    static inline void apply(model::cached_envelope_collection<GeometryCollection, Box> const& geometry,
+                             OtherBox & mbr, Strategy const& strategy)
+    {
+        envelope<GeometryCollection>::apply(geometry.base(), mbr, strategy);
+    }
+};
+
+} // namespace dispatch
+
+}} // namespace boost::geometry
+
+#endif // CACHED_ENVELOPE_COLLECTION_HPP
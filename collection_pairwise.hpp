@@ -0,0 +1,416 @@
+#ifndef COLLECTION_PAIRWISE_HPP
+#define COLLECTION_PAIRWISE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/geometry/index/rtree.hpp>
+
+#include "collection_rtree.hpp"
+#include "geometry.hpp"
+#include "visit_parallel.hpp"
+
+namespace boost { namespace geometry {
+
+// Pairs of StaticGeometries passed into visit_pairwise
+enum class pairwise_pruning
+{
+    none,   // all pairs
+    sweep,  // pairs with intersecting envelopes found by sorting and sweeping along x
+    rtree   // pairs with intersecting envelopes found by querying an rtree
+};
+
+namespace detail { namespace collection_pairwise {
+
+// StaticGeometries of one GeometryCollection and their envelopes
+template <typename Box>
+struct side
+{
+    std::vector<collection_rtree::leaf> leaves;
+    std::vector<Box> boxes;
+};
+
+template <typename Box>
+struct less_min_x
+{
+    bool operator()(Box const& b1, Box const& b2) const
+    {
+        return geometry::get<min_corner, 0>(b1) < geometry::get<min_corner, 0>(b2);
+    }
+};
+
+template <typename Box>
+inline void sort_by_min_x(side<Box> & s)
+{
+    std::vector<std::size_t> order(s.leaves.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j)
+    {
+        return less_min_x<Box>()(s.boxes[i], s.boxes[j]);
+    });
+
+    side<Box> sorted;
+    sorted.leaves.reserve(order.size());
+    sorted.boxes.reserve(order.size());
+    for (std::size_t i : order)
+    {
+        sorted.leaves.push_back(s.leaves[i]);
+        sorted.boxes.push_back(s.boxes[i]);
+    }
+    s = std::move(sorted);
+}
+
+template
+<
+    typename GeometryCollection1, typename GeometryCollection2,
+    typename TypeSequence1, typename TypeSequence2,
+    typename IndexSequence = std::make_index_sequence
+        <
+            util::sequence_size<TypeSequence1>::value * util::sequence_size<TypeSequence2>::value
+        >
+>
+struct leaf_visit_two;
+
+// Table of handlers for all pairs of types so the function is called with one
+// indirect call for each pair of StaticGeometries
+template
+<
+    typename GeometryCollection1, typename GeometryCollection2,
+    typename TypeSequence1, typename TypeSequence2,
+    std::size_t ...Is
+>
+struct leaf_visit_two
+    <
+        GeometryCollection1, GeometryCollection2,
+        TypeSequence1, TypeSequence2,
+        std::index_sequence<Is...>
+    >
+{
+    static const std::size_t M = util::sequence_size<TypeSequence2>::value;
+
+    template <typename Function>
+    static bool apply(Function & function, collection_rtree::leaf const& l1, collection_rtree::leaf const& l2)
+    {
+        using handler_t = bool (*)(Function &, void const*, void const*);
+        static const handler_t handlers[] = { &call<Is, Function>... };
+        return handlers[l1.type * M + l2.type](function, l1.pointer, l2.pointer);
+    }
+
+private:
+    template <std::size_t I, typename Function>
+    static bool call(Function & function, void const* pointer1, void const* pointer2)
+    {
+        using geometry1_t = typename util::sequence_element<I / M, TypeSequence1>::type;
+        using geometry2_t = typename util::sequence_element<I % M, TypeSequence2>::type;
+        return call(function, pointer1, pointer2,
+                    boost::type_identity<geometry1_t>(), boost::type_identity<geometry2_t>(),
+                    std::integral_constant
+                        <
+                            bool,
+                            util::is_geometry_collection<geometry1_t>::value
+                         || util::is_geometry_collection<geometry2_t>::value
+                        >());
+    }
+
+    template <typename Function, typename Geometry1, typename Geometry2>
+    static bool call(Function & function, void const* pointer1, void const* pointer2,
+                     boost::type_identity<Geometry1>, boost::type_identity<Geometry2>,
+                     std::false_type /*is_gc*/)
+    {
+        using geometry1_t = util::transcribe_const_t<GeometryCollection1, Geometry1>;
+        using geometry2_t = util::transcribe_const_t<GeometryCollection2, Geometry2>;
+        geometry1_t * g1 = static_cast<geometry1_t *>(const_cast<void *>(pointer1));
+        geometry2_t * g2 = static_cast<geometry2_t *>(const_cast<void *>(pointer2));
+        return detail::call_visit_function(function, *g1, *g2);
+    }
+
+    // GeometryCollections are never stored as leaves
+    template <typename Function, typename Geometry1, typename Geometry2>
+    static bool call(Function & , void const* , void const* ,
+                     boost::type_identity<Geometry1>, boost::type_identity<Geometry2>,
+                     std::true_type /*is_gc*/)
+    {
+        return true;
+    }
+};
+
+// Both GeometryCollections flattened once. The work is split into tasks which can be
+// processed independently, one task for each StaticGeometry of the first collection
+// and with sweep also one for each StaticGeometry of the second collection.
+template <typename GeometryCollection1, typename GeometryCollection2, typename Box>
+class pairwise
+{
+    using leaf_visit_t = leaf_visit_two
+        <
+            GeometryCollection1, GeometryCollection2,
+            typename collection_rtree::leaf_types<util::remove_cref_t<GeometryCollection1>>::type,
+            typename collection_rtree::leaf_types<util::remove_cref_t<GeometryCollection2>>::type
+        >;
+    using rtree_value_t = std::pair<Box, std::size_t>;
+    using rtree_t = index::rtree<rtree_value_t, index::rstar<16>>;
+
+public:
+    pairwise(GeometryCollection1 & collection1, GeometryCollection2 & collection2,
+             pairwise_pruning pruning)
+        : m_pruning(pruning)
+    {
+        gather(collection1, m_first);
+        gather(collection2, m_second);
+
+        if (m_pruning == pairwise_pruning::sweep)
+        {
+            sort_by_min_x(m_first);
+            sort_by_min_x(m_second);
+        }
+        else if (m_pruning == pairwise_pruning::rtree)
+        {
+            std::vector<rtree_value_t> values;
+            values.reserve(m_second.boxes.size());
+            for (std::size_t i = 0; i < m_second.boxes.size(); ++i)
+            {
+                values.emplace_back(m_second.boxes[i], i);
+            }
+            // Packing algorithm is used by the range constructor
+            rtree_t(values.begin(), values.end()).swap(m_rtree);
+        }
+    }
+
+    std::size_t tasks() const
+    {
+        return m_first.leaves.size()
+             + (m_pruning == pairwise_pruning::sweep ? m_second.leaves.size() : 0);
+    }
+
+    // Returns false if the function returned false
+    template <typename Function>
+    bool apply(Function & function, std::size_t task) const
+    {
+        std::size_t const size1 = m_first.leaves.size();
+        return task < size1
+             ? apply_first(function, task)
+             : apply_second(function, task - size1);
+    }
+
+private:
+    template <typename GeometryCollection>
+    static void gather(GeometryCollection & collection, side<Box> & s)
+    {
+        collection_rtree::for_each_leaf<Box>(collection,
+            [&](Box const& envelope, collection_rtree::leaf const& l)
+            {
+                s.leaves.push_back(l);
+                s.boxes.push_back(envelope);
+            });
+    }
+
+    // Pairs of the i-th StaticGeometry of the first collection and StaticGeometries of
+    // the second collection. With sweep the ones starting at the same x or further.
+    template <typename Function>
+    bool apply_first(Function & function, std::size_t i) const
+    {
+        Box const& box = m_first.boxes[i];
+        if (m_pruning == pairwise_pruning::none)
+        {
+            for (std::size_t j = 0; j < m_second.leaves.size(); ++j)
+            {
+                if (! call(function, i, j))
+                {
+                    return false;
+                }
+            }
+        }
+        else if (m_pruning == pairwise_pruning::sweep)
+        {
+            std::size_t const first = std::size_t(std::lower_bound(m_second.boxes.begin(), m_second.boxes.end(),
+                                                                   box, less_min_x<Box>())
+                                                  - m_second.boxes.begin());
+            return sweep(box, m_second.boxes, first, [&](std::size_t j)
+            {
+                return call(function, i, j);
+            });
+        }
+        else
+        {
+            for (auto it = m_rtree.qbegin(index::intersects(box)); it != m_rtree.qend(); ++it)
+            {
+                if (! call(function, i, it->second))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Pairs of StaticGeometries of the first collection starting further along x than
+    // the j-th StaticGeometry of the second collection, only used with sweep
+    template <typename Function>
+    bool apply_second(Function & function, std::size_t j) const
+    {
+        Box const& box = m_second.boxes[j];
+        std::size_t const first = std::size_t(std::upper_bound(m_first.boxes.begin(), m_first.boxes.end(),
+                                                               box, less_min_x<Box>())
+                                              - m_first.boxes.begin());
+        return sweep(box, m_first.boxes, first, [&](std::size_t i)
+        {
+            return call(function, i, j);
+        });
+    }
+
+    template <typename Call>
+    static bool sweep(Box const& box, std::vector<Box> const& boxes, std::size_t first, Call const& call)
+    {
+        auto const max_x = geometry::get<max_corner, 0>(box);
+        for (std::size_t k = first; k < boxes.size() && geometry::get<min_corner, 0>(boxes[k]) <= max_x; ++k)
+        {
+            if (geometry::intersects(box, boxes[k]) && ! call(k))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Function>
+    bool call(Function & function, std::size_t i, std::size_t j) const
+    {
+        return leaf_visit_t::apply(function, m_first.leaves[i], m_second.leaves[j]);
+    }
+
+    pairwise_pruning m_pruning;
+    side<Box> m_first;
+    side<Box> m_second;
+    rtree_t m_rtree;
+};
+
+// Processes the tasks in parallel, each thread calls its own copy of the function
+template <typename Function, typename Pairwise>
+inline bool apply_parallel(std::vector<Function> & functions, Pairwise const& pw)
+{
+    // Number of tasks taken by a thread at once
+    static const std::size_t grain_size = 256;
+
+    std::size_t const size = pw.tasks();
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> stop(false);
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+
+    auto work = [&](std::size_t id)
+    {
+        try
+        {
+            for (;;)
+            {
+                std::size_t const first = next.fetch_add(grain_size);
+                if (first >= size || stop.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                std::size_t const last = (std::min)(first + grain_size, size);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    if (! pw.apply(functions[id], i))
+                    {
+                        stop.store(true);
+                        return;
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (! exception)
+            {
+                exception = std::current_exception();
+            }
+            stop.store(true);
+        }
+    };
+
+    // work(0) processes all tasks if other workers are busy
+    detail::visit_parallel::thread_pool::instance().run(functions.size(), work);
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+
+    return ! stop.load();
+}
+
+template <typename GeometryCollection1, typename GeometryCollection2>
+using pairwise_type = pairwise
+    <
+        GeometryCollection1, GeometryCollection2,
+        model::box<typename geometry::point_type<GeometryCollection1>::type>
+    >;
+
+}} // namespace detail::collection_pairwise
+
+// Calls the function for pairs of StaticGeometries, the first one stored in the first
+// Geometry and the second one stored in the second Geometry, including the ones stored
+// in nested GeometryCollections, e.g.:
+//     visit_pairwise([](auto const& g1, auto const& g2) { ... }, gc1, gc2);
+// Both GeometryCollections are traversed once and pairs are passed through a table
+// of handlers so the StaticGeometries are not dispatched again for each pair.
+// NOTE: By default only pairs with intersecting envelopes are passed, see
+//   pairwise_pruning. Empty StaticGeometries are never passed. The order of pairs
+//   is unspecified.
+// NOTE: If the function returns false the traversal is stopped and false is returned.
+template <typename BinaryFunction, typename GeometryCollection1, typename GeometryCollection2>
+inline bool visit_pairwise(BinaryFunction && function,
+                           GeometryCollection1 & collection1,
+                           GeometryCollection2 & collection2,
+                           pairwise_pruning pruning = pairwise_pruning::sweep)
+{
+    using pairwise_t = detail::collection_pairwise::pairwise_type<GeometryCollection1, GeometryCollection2>;
+    pairwise_t const pw(collection1, collection2, pruning);
+    std::size_t const size = pw.tasks();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (! pw.apply(function, i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parallel version of visit_pairwise. The function is copied for each thread and
+// the copies are returned together with a flag so the per-thread results can be
+// reduced, the same way as in visit_parallel.
+// NOTE: The flag is false if the function returned false and the traversal was
+//   stopped as soon as possible. Other threads may still call their copies of
+//   the function for a few pairs.
+// NOTE: If threads is 0 std::thread::hardware_concurrency() threads are used,
+//   including the calling thread, taken from the pool used by visit_parallel.
+template <typename BinaryFunction, typename GeometryCollection1, typename GeometryCollection2>
+inline std::pair<std::vector<BinaryFunction>, bool> visit_pairwise_parallel(BinaryFunction const& function,
+                                                                            GeometryCollection1 & collection1,
+                                                                            GeometryCollection2 & collection2,
+                                                                            pairwise_pruning pruning = pairwise_pruning::sweep,
+                                                                            std::size_t threads = 0)
+{
+    using pairwise_t = detail::collection_pairwise::pairwise_type<GeometryCollection1, GeometryCollection2>;
+    if (threads == 0)
+    {
+        threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    std::vector<BinaryFunction> functions(threads, function);
+    pairwise_t const pw(collection1, collection2, pruning);
+    bool const result = detail::collection_pairwise::apply_parallel(functions, pw);
+    return std::make_pair(std::move(functions), result);
+}
+
+}} // namespace boost::geometry
+
+#endif // COLLECTION_PAIRWISE_HPP
@@ -0,0 +1,201 @@
+#ifndef COLLECTION_RTREE_HPP
+#define COLLECTION_RTREE_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/geometry/index/rtree.hpp>
+
+#include "envelope.hpp"
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace collection_rtree {
+
+// Types of StaticGeometries stored in the Geometry, a StaticGeometry is its only leaf
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct leaf_types
+{
+    typedef util::type_sequence<Geometry> type;
+};
+
+template <typename Geometry>
+struct leaf_types<Geometry, dynamic_geometry_tag>
+    : traits::geometry_types<Geometry>
+{};
+
+template <typename Geometry>
+struct leaf_types<Geometry, geometry_collection_tag>
+    : traits::geometry_types<Geometry>
+{};
+
+// StaticGeometry stored in a Geometry, type is the index in leaf_types
+struct leaf
+{
+    std::size_t type;
+    void const* pointer;
+};
+
+template <typename GeometryCollection, typename TypeSequence>
+struct leaf_visit;
+
+template <typename GeometryCollection, typename ...Geometries>
+struct leaf_visit<GeometryCollection, util::type_sequence<Geometries...>>
+{
+    template <typename Function>
+    static bool apply(Function & function, leaf const& l)
+    {
+        using handler_t = bool (*)(Function &, void const*);
+        static const handler_t handlers[] = { &call<Function, Geometries>... };
+        return handlers[l.type](function, l.pointer);
+    }
+
+private:
+    template <typename Function, typename Geometry>
+    static bool call(Function & function, void const* pointer)
+    {
+        return call(function, pointer, boost::type_identity<Geometry>(),
+                    util::is_geometry_collection<Geometry>());
+    }
+
+    template <typename Function, typename Geometry>
+    static bool call(Function & function, void const* pointer,
+                     boost::type_identity<Geometry>, std::false_type /*is_gc*/)
+    {
+        using geometry_t = util::transcribe_const_t<GeometryCollection, Geometry>;
+        geometry_t * g = static_cast<geometry_t *>(const_cast<void *>(pointer));
+        return detail::call_visit_function(function, *g);
+    }
+
+    // GeometryCollections are never stored as leaves
+    template <typename Function, typename Geometry>
+    static bool call(Function & , void const* ,
+                     boost::type_identity<Geometry>, std::true_type /*is_gc*/)
+    {
+        return true;
+    }
+};
+
+// Calls the function with envelopes and leaves of non-empty StaticGeometries stored
+// in the GeometryCollection and in nested GeometryCollections, depth-first
+template <typename Box, typename GeometryCollection, typename Function>
+inline void for_each_leaf(GeometryCollection & collection, Function && function)
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(
+        (! traits::visit_yields_temporaries<util::remove_cref_t<GeometryCollection>>::value),
+        "Leaves can't point to temporary StaticGeometries created during traversal of this Geometry.",
+        GeometryCollection);
+
+    using types_t = typename leaf_types<util::remove_cref_t<GeometryCollection>>::type;
+
+    geometry::visit_depth_first([&](auto & g)
+    {
+        using geometry_t = util::remove_cref_t<decltype(g)>;
+        static const std::size_t type = geometry::detail::sequence_index<geometry_t, types_t>::value;
+        BOOST_GEOMETRY_STATIC_ASSERT(type < util::sequence_size<types_t>::value,
+            "The Geometry is not in geometry_types.",
+            geometry_t);
+
+        if (! geometry::is_empty(g))
+        {
+            function(geometry::return_envelope<Box>(g), leaf{ type, boost::addressof(g) });
+        }
+    }, collection);
+}
+
+}} // namespace detail::collection_rtree
+
+namespace index {
+
+// Packed rtree of envelopes of StaticGeometries stored in a GeometryCollection,
+// including the ones stored in nested GeometryCollections, e.g.:
+//     collection_rtree<gc_t const> rtree(gc);
+//     rtree.query(index::intersects(box), [](auto const& g) { ... });
+// Values are pairs of envelopes and ids of the StaticGeometries. Empty
+// StaticGeometries are not indexed.
+// NOTE: The predicates are checked for envelopes so the StaticGeometries have to be
+//   checked by the caller if exact results are needed.
+// NOTE: The GeometryCollection has to outlive the rtree and can't be modified.
+//   If GeometryCollection is a const type the StaticGeometries are passed as const.
+template
+<
+    typename GeometryCollection,
+    typename Box = model::box<typename geometry::point_type<GeometryCollection>::type>,
+    typename Parameters = index::rstar<16>
+>
+class collection_rtree
+{
+    using types_t = typename geometry::detail::collection_rtree::leaf_types<util::remove_cref_t<GeometryCollection>>::type;
+
+public:
+    using value_type = std::pair<Box, std::size_t>;
+    using rtree_type = index::rtree<value_type, Parameters>;
+
+    explicit collection_rtree(GeometryCollection & collection)
+    {
+        std::vector<value_type> values;
+        geometry::detail::collection_rtree::for_each_leaf<Box>(collection,
+            [&](Box const& envelope, geometry::detail::collection_rtree::leaf const& l)
+            {
+                values.emplace_back(envelope, m_leaves.size());
+                m_leaves.push_back(l);
+            });
+
+        // Packing algorithm is used by the range constructor
+        rtree_type(values.begin(), values.end()).swap(m_rtree);
+    }
+
+    std::size_t size() const
+    {
+        return m_leaves.size();
+    }
+
+    rtree_type const& rtree() const
+    {
+        return m_rtree;
+    }
+
+    // Calls the function with the StaticGeometry of this id
+    template <typename UnaryFunction>
+    bool visit(std::size_t id, UnaryFunction && function) const
+    {
+        return visit_leaf(id, function);
+    }
+
+    // Calls the function with StaticGeometries whose envelopes satisfy the predicates.
+    // NOTE: The query is stopped if the function returns false. In this case
+    //   false is returned, otherwise true.
+    template <typename Predicates, typename UnaryFunction>
+    bool query(Predicates const& predicates, UnaryFunction && function) const
+    {
+        for (auto it = m_rtree.qbegin(predicates); it != m_rtree.qend(); ++it)
+        {
+            if (! visit_leaf(it->second, function))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    template <typename UnaryFunction>
+    bool visit_leaf(std::size_t id, UnaryFunction & function) const
+    {
+        return geometry::detail::collection_rtree::leaf_visit
+            <
+                GeometryCollection, types_t
+            >::apply(function, m_leaves[id]);
+    }
+
+    std::vector<geometry::detail::collection_rtree::leaf> m_leaves;
+    rtree_type m_rtree;
+};
+
+} // namespace index
+
+}} // namespace boost::geometry
+
+#endif // COLLECTION_RTREE_HPP
@@ -0,0 +1,446 @@
+#ifndef DISTANCE_HPP
+#define DISTANCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/geometry/algorithms/comparable_distance.hpp>
+#include <boost/geometry/algorithms/detail/distance/is_comparable.hpp>
+#include <boost/geometry/algorithms/distance.hpp>
+
+#include "collection_pairwise.hpp"
+#include "collection_rtree.hpp"
+#include "envelope.hpp"
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace collection_distance {
+
+// StaticGeometry and the comparable distance of its envelope to an envelope of the
+// other geometry which is the lower bound of the comparable distance to the other
+// geometry
+template <typename Result>
+struct candidate
+{
+    Result bound;
+    std::size_t index;
+};
+
+// StaticGeometries of the first geometry gathered in one traversal with their envelopes
+template <typename Geometry>
+class gathered_side
+{
+    using types_t = typename collection_rtree::leaf_types<Geometry>::type;
+
+public:
+    using box_type = model::box<typename point_type<Geometry>::type>;
+
+    explicit gathered_side(Geometry const& geometry)
+    {
+        collection_rtree::for_each_leaf<box_type>(geometry,
+            [&](box_type const& envelope, collection_rtree::leaf const& l)
+            {
+                m_side.leaves.push_back(l);
+                m_side.boxes.push_back(envelope);
+            });
+    }
+
+    std::size_t size() const
+    {
+        return m_side.leaves.size();
+    }
+
+    box_type const& box(std::size_t id) const
+    {
+        return m_side.boxes[id];
+    }
+
+    template <typename Function>
+    void visit(std::size_t id, Function && function) const
+    {
+        collection_rtree::leaf_visit<Geometry const, types_t>::apply(function, m_side.leaves[id]);
+    }
+
+private:
+    collection_pairwise::side<box_type> m_side;
+};
+
+// StaticGeometries of the second geometry indexed by collection_rtree. For an envelope
+// they're taken with the nearest query in the order of distances of envelopes so only the
+// nodes of the rtree close to the envelope are visited.
+// NOTE: The query iterator of the nearest query is incremental, the nodes are visited
+//   lazily as the iterator is incremented so all values can be requested and the query
+//   is stopped by the function. Each value is passed at most once.
+template <typename Rtree>
+class indexed_side
+{
+public:
+    explicit indexed_side(Rtree const& rtree)
+        : m_rtree(rtree)
+    {}
+
+    std::size_t size() const
+    {
+        return m_rtree.size();
+    }
+
+    auto bounds() const
+    {
+        return m_rtree.rtree().bounds();
+    }
+
+    template <typename Result, typename Box, typename Function>
+    void for_each_nearest(Box const& box, Function && function) const
+    {
+        auto const& rtree = m_rtree.rtree();
+        for (auto it = rtree.qbegin(index::nearest(box, unsigned(rtree.size()))); it != rtree.qend(); ++it)
+        {
+            if (! function(Result(geometry::comparable_distance(box, it->first)), it->second))
+            {
+                return;
+            }
+        }
+    }
+
+    template <typename Function>
+    void visit(std::size_t id, Function && function) const
+    {
+        m_rtree.visit(id, function);
+    }
+
+private:
+    Rtree const& m_rtree;
+};
+
+// StaticGeometries of the first geometry are checked in the order of distances of
+// their envelopes to the envelope of the second geometry. For each of them
+// StaticGeometries of the second geometry are taken in the order of distances of
+// envelopes. The search is stopped when the distance of envelopes is not smaller than
+// the smallest distance found so far. Comparable distances are calculated for the
+// checked pairs and the distance only for the closest one.
+template <typename Result, typename First, typename Second>
+class nearest_leaves
+{
+public:
+    nearest_leaves(First const& first, Second const& second)
+        : m_first(first)
+        , m_second(second)
+    {
+        if (m_first.size() == 0 || m_second.size() == 0)
+        {
+            BOOST_THROW_EXCEPTION(empty_input_exception());
+        }
+
+        auto const envelope2 = m_second.bounds();
+        std::vector<candidate<Result>> first_candidates;
+        first_candidates.reserve(m_first.size());
+        for (std::size_t i = 0; i < m_first.size(); ++i)
+        {
+            Result const bound = geometry::comparable_distance(m_first.box(i), envelope2);
+            first_candidates.push_back(candidate<Result>{ bound, i });
+        }
+        std::sort(first_candidates.begin(), first_candidates.end(),
+                  [](candidate<Result> const& c1, candidate<Result> const& c2)
+                  {
+                      return c1.bound < c2.bound;
+                  });
+
+        bool found = false;
+        for (candidate<Result> const& c1 : first_candidates)
+        {
+            if (found && ! (c1.bound < m_comparable_distance))
+            {
+                break;
+            }
+
+            m_second.template for_each_nearest<Result>(m_first.box(c1.index),
+                [&](Result const& bound, std::size_t j)
+                {
+                    if (found && ! (bound < m_comparable_distance))
+                    {
+                        return false;
+                    }
+
+                    Result const d = comparable_distance(c1.index, j);
+                    if (! found || d < m_comparable_distance)
+                    {
+                        m_comparable_distance = d;
+                        m_first_index = c1.index;
+                        m_second_index = j;
+                        found = true;
+                    }
+                    return true;
+                });
+        }
+    }
+
+    Result comparable_distance() const
+    {
+        return m_comparable_distance;
+    }
+
+    Result distance() const
+    {
+        Result result = 0;
+        visit(m_first_index, m_second_index, [&](auto const& g1, auto const& g2)
+        {
+            result = geometry::distance(g1, g2);
+        });
+        return result;
+    }
+
+private:
+    Result comparable_distance(std::size_t i, std::size_t j) const
+    {
+        Result result = 0;
+        visit(i, j, [&](auto const& g1, auto const& g2)
+        {
+            result = geometry::comparable_distance(g1, g2);
+        });
+        return result;
+    }
+
+    template <typename Function>
+    void visit(std::size_t i, std::size_t j, Function && function) const
+    {
+        m_first.visit(i, [&](auto const& g1)
+        {
+            m_second.visit(j, [&](auto const& g2)
+            {
+                function(g1, g2);
+            });
+        });
+    }
+
+    First const& m_first;
+    Second const& m_second;
+    Result m_comparable_distance;
+    std::size_t m_first_index;
+    std::size_t m_second_index;
+};
+
+template <typename Result, typename Leaves>
+inline Result result(Leaves const& leaves, std::true_type /*is_comparable*/)
+{
+    return leaves.comparable_distance();
+}
+
+template <typename Result, typename Leaves>
+inline Result result(Leaves const& leaves, std::false_type /*is_comparable*/)
+{
+    return leaves.distance();
+}
+
+// True if the StaticGeometry may be nearer than comparable, checked with its envelope.
+// Envelopes of Points are not calculated because it's not faster than the distance.
+template
+<
+    typename Box, typename Geometry, typename Envelope, typename Result,
+    std::enable_if_t<! std::is_same<typename tag<Geometry>::type, point_tag>::value, int> = 0
+>
+inline bool may_be_nearer(Envelope const& envelope, Geometry const& geometry, Result const& comparable)
+{
+    return Result(geometry::comparable_distance(envelope, geometry::return_envelope<Box>(geometry))) < comparable;
+}
+
+template
+<
+    typename Box, typename Geometry, typename Envelope, typename Result,
+    std::enable_if_t<std::is_same<typename tag<Geometry>::type, point_tag>::value, int> = 0
+>
+inline bool may_be_nearer(Envelope const& , Geometry const& , Result const& )
+{
+    return true;
+}
+
+template <typename Result, typename Geometry1, typename Geometry2>
+inline Result result(Geometry1 const& , Geometry2 const& , Result const& comparable,
+                     std::true_type /*is_comparable*/)
+{
+    return comparable;
+}
+
+template <typename Result, typename Geometry1, typename Geometry2>
+inline Result result(Geometry1 const& geometry1, Geometry2 const& geometry2, Result const& ,
+                     std::false_type /*is_comparable*/)
+{
+    return geometry::distance(geometry1, geometry2);
+}
+
+template <typename Geometry1, typename Geometry2, typename Strategy>
+struct distance
+{
+    using return_type = typename strategy::distance::services::return_type
+        <
+            Strategy,
+            typename point_type<Geometry1>::type,
+            typename point_type<Geometry2>::type
+        >::type;
+
+    using is_comparable_t = std::integral_constant
+        <
+            bool, detail::distance::is_comparable<Strategy>::value
+        >;
+    using box2_t = model::box<typename point_type<Geometry2>::type>;
+
+    // NOTE: If the first geometry has more than one StaticGeometry the second one is
+    //   indexed with collection_rtree in each call. If it's used more than once it's
+    //   faster to build the collection_rtree once and pass it into index::distance.
+    static inline return_type apply(Geometry1 const& geometry1, Geometry2 const& geometry2,
+                                    Strategy const& )
+    {
+        gathered_side<Geometry1> const first(geometry1);
+        if (first.size() == 1)
+        {
+            return apply_one(first, geometry2);
+        }
+
+        index::collection_rtree<Geometry2 const, box2_t> const rtree(geometry2);
+        indexed_side<index::collection_rtree<Geometry2 const, box2_t>> const second(rtree);
+        nearest_leaves
+            <
+                return_type, gathered_side<Geometry1>,
+                indexed_side<index::collection_rtree<Geometry2 const, box2_t>>
+            > const leaves(first, second);
+        return result<return_type>(leaves, is_comparable_t());
+    }
+
+private:
+    // One StaticGeometry, e.g. a Point, is compared with StaticGeometries of the second
+    // geometry in one traversal without storing them. The distance is calculated only
+    // if the distance of envelopes is smaller than the smallest one found so far.
+    static inline return_type apply_one(gathered_side<Geometry1> const& first,
+                                        Geometry2 const& geometry2)
+    {
+        bool found = false;
+        return_type comparable = 0;
+        return_type distance = 0;
+        first.visit(0, [&](auto const& g1)
+        {
+            geometry::visit_depth_first([&](auto const& g2)
+            {
+                if (geometry::is_empty(g2)
+                    || (found && ! may_be_nearer<box2_t>(first.box(0), g2, comparable)))
+                {
+                    return;
+                }
+
+                return_type const d = geometry::comparable_distance(g1, g2);
+                if (! found || d < comparable)
+                {
+                    comparable = d;
+                    distance = result(g1, g2, d, is_comparable_t());
+                    found = true;
+                }
+            }, geometry2);
+        });
+
+        if (! found)
+        {
+            BOOST_THROW_EXCEPTION(empty_input_exception());
+        }
+        return distance;
+    }
+};
+
+}} // namespace detail::collection_distance
+
+namespace dispatch
+{
+
+// NOTE: Distance strategies are specific to pairs of geometry types so distances of
+//   StaticGeometries are calculated with their default strategies. If the Strategy
+//   is comparable then the comparable distance is returned.
+// NOTE: DynamicGeometries and GeometryCollections are always the second geometry
+//   because their geometry_id is greater than the ids of StaticGeometries.
+template
+<
+    typename Geometry1, typename Geometry2, typename Strategy,
+    typename Tag1, typename StrategyTag
+>
+struct distance
+    <
+        Geometry1, Geometry2, Strategy,
+        Tag1, dynamic_geometry_tag, StrategyTag,
+        false
+    >
+    : detail::collection_distance::distance<Geometry1, Geometry2, Strategy>
+{};
+
+template
+<
+    typename Geometry1, typename Geometry2, typename Strategy,
+    typename Tag1, typename StrategyTag
+>
+struct distance
+    <
+        Geometry1, Geometry2, Strategy,
+        Tag1, geometry_collection_tag, StrategyTag,
+        false
+    >
+    : detail::collection_distance::distance<Geometry1, Geometry2, Strategy>
+{};
+
+} // namespace dispatch
+
+namespace index {
+
+// Distance between the Geometry and StaticGeometries indexed by the collection_rtree,
+// e.g. to calculate distances of many geometries to the same GeometryCollection:
+//     index::collection_rtree<gc_t const> const rtree(gc);
+//     for (point_t const& p : points)
+//         result.push_back(index::distance(p, rtree));
+// Only the nodes of the rtree near the Geometry are visited.
+// NOTE: The function has to be called with the namespace because geometry::distance
+//   would be found for collection_rtree with argument dependent lookup and fail.
+template
+<
+    typename Geometry, typename GeometryCollection, typename Box, typename Parameters
+>
+inline typename default_distance_result<Geometry, util::remove_cref_t<GeometryCollection>>::type
+distance(Geometry const& geometry,
+         index::collection_rtree<GeometryCollection, Box, Parameters> const& rtree)
+{
+    geometry::concepts::check<Geometry const>();
+
+    using result_t = typename default_distance_result<Geometry, util::remove_cref_t<GeometryCollection>>::type;
+    using rtree_t = index::collection_rtree<GeometryCollection, Box, Parameters>;
+    geometry::detail::collection_distance::gathered_side<Geometry> const first(geometry);
+    geometry::detail::collection_distance::indexed_side<rtree_t> const second(rtree);
+    return geometry::detail::collection_distance::nearest_leaves
+        <
+            result_t,
+            geometry::detail::collection_distance::gathered_side<Geometry>,
+            geometry::detail::collection_distance::indexed_side<rtree_t>
+        >(first, second).distance();
+}
+
+template
+<
+    typename Geometry, typename GeometryCollection, typename Box, typename Parameters
+>
+inline typename comparable_distance_result<Geometry, util::remove_cref_t<GeometryCollection>>::type
+comparable_distance(Geometry const& geometry,
+                    index::collection_rtree<GeometryCollection, Box, Parameters> const& rtree)
+{
+    geometry::concepts::check<Geometry const>();
+
+    using result_t = typename comparable_distance_result<Geometry, util::remove_cref_t<GeometryCollection>>::type;
+    using rtree_t = index::collection_rtree<GeometryCollection, Box, Parameters>;
+    geometry::detail::collection_distance::gathered_side<Geometry> const first(geometry);
+    geometry::detail::collection_distance::indexed_side<rtree_t> const second(rtree);
+    return geometry::detail::collection_distance::nearest_leaves
+        <
+            result_t,
+            geometry::detail::collection_distance::gathered_side<Geometry>,
+            geometry::detail::collection_distance::indexed_side<rtree_t>
+        >(first, second).comparable_distance();
+}
+
+} // namespace index
+
+}} // namespace boost::geometry
+
+#endif // DISTANCE_HPP
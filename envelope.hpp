@@ -0,0 +1,160 @@
+#ifndef ENVELOPE_HPP
+#define ENVELOPE_HPP
+
+#include <boost/geometry/algorithms/assign.hpp>
+#include <boost/geometry/algorithms/envelope.hpp>
+#include <boost/geometry/algorithms/expand.hpp>
+#include <boost/geometry/algorithms/is_empty.hpp>
+#include <boost/geometry/strategies/envelope.hpp>
+#include <boost/geometry/strategies/expand.hpp>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace dispatch
+{
+
+template <typename Geometry>
+struct is_empty<Geometry, dynamic_geometry_tag>
+{
+    static inline bool apply(Geometry const& geom)
+    {
+        bool result = true;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = is_empty<util::remove_cref_t<decltype(g)>>::apply(g);
+        }, geom);
+        return result;
+    }
+};
+
+// Empty if all StaticGeometries stored in nested GeometryCollections are empty
+template <typename Geometry>
+struct is_empty<Geometry, geometry_collection_tag>
+{
+    static inline bool apply(Geometry const& geom)
+    {
+        return geometry::visit_depth_first([](auto const& g)
+        {
+            return is_empty<util::remove_cref_t<decltype(g)>>::apply(g);
+        }, geom);
+    }
+};
+
+template <typename Geometry>
+struct is_empty<Geometry, tupled_geometry_tag>
+    : is_empty<Geometry, geometry_collection_tag>
+{};
+
+// NOTE: Envelope strategies are specific to geometry types so envelopes of
+//   StaticGeometries are calculated with their default strategies.
+template <typename Geometry>
+struct envelope<Geometry, dynamic_geometry_tag>
+{
+    template <typename Box, typename Strategy>
+    static inline void apply(Geometry const& geom, Box & mbr, Strategy const& )
+    {
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            geometry::envelope(g, mbr);
+        }, geom);
+    }
+};
+
+// Envelopes of non-empty StaticGeometries stored in nested GeometryCollections
+// are combined the same way as envelopes of elements of multi-geometries.
+template <typename Geometry>
+struct envelope<Geometry, geometry_collection_tag>
+{
+    template <typename Box, typename Strategy>
+    static inline void apply(Geometry const& geom, Box & mbr, Strategy const& )
+    {
+        bool initialized = false;
+        geometry::visit_depth_first([&](auto const& g)
+        {
+            if (geometry::is_empty(g))
+            {
+                return;
+            }
+            if (! initialized)
+            {
+                geometry::envelope(g, mbr);
+                initialized = true;
+            }
+            else
+            {
+                Box helper_mbr;
+                geometry::envelope(g, helper_mbr);
+                geometry::expand(mbr, helper_mbr);
+            }
+        }, geom);
+        if (! initialized)
+        {
+            geometry::assign_inverse(mbr);
+        }
+    }
+};
+
+template <typename Geometry>
+struct envelope<Geometry, tupled_geometry_tag>
+    : envelope<Geometry, geometry_collection_tag>
+{};
+
+// The Box is expanded by the envelope of the Geometry so the Strategy is a strategy
+// expanding a Box by a Box.
+template <typename Box, typename Geometry>
+struct expand_by_envelope
+{
+    template <typename Strategy>
+    static inline void apply(Box & box, Geometry const& geom, Strategy const& strategy)
+    {
+        if (! geometry::is_empty(geom))
+        {
+            Box mbr;
+            geometry::envelope(geom, mbr);
+            expand<Box, Box>::apply(box, mbr, strategy);
+        }
+    }
+};
+
+template <typename Box, typename Geometry>
+struct expand<Box, Geometry, box_tag, dynamic_geometry_tag>
+    : expand_by_envelope<Box, Geometry>
+{};
+
+template <typename Box, typename Geometry>
+struct expand<Box, Geometry, box_tag, geometry_collection_tag>
+    : expand_by_envelope<Box, Geometry>
+{};
+
+template <typename Box, typename Geometry>
+struct expand<Box, Geometry, box_tag, tupled_geometry_tag>
+    : expand_by_envelope<Box, Geometry>
+{};
+
+} // namespace dispatch
+
+namespace strategy { namespace expand { namespace services
+{
+
+template <typename CSTag, typename CalculationType>
+struct default_strategy<dynamic_geometry_tag, CSTag, CalculationType>
+    : default_strategy<box_tag, CSTag, CalculationType>
+{};
+
+template <typename CSTag, typename CalculationType>
+struct default_strategy<geometry_collection_tag, CSTag, CalculationType>
+    : default_strategy<box_tag, CSTag, CalculationType>
+{};
+
+template <typename CSTag, typename CalculationType>
+struct default_strategy<tupled_geometry_tag, CSTag, CalculationType>
+    : default_strategy<box_tag, CSTag, CalculationType>
+{};
+
+}}} // namespace strategy::expand::services
+
+}} // namespace boost::geometry
+
+#endif // ENVELOPE_HPP
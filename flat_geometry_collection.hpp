@@ -0,0 +1,744 @@
+#ifndef FLAT_GEOMETRY_COLLECTION_HPP
+#define FLAT_GEOMETRY_COLLECTION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace model {
+
+template <typename Point> class flat_collection_view;
+
+// Views of geometries stored in flat_geometry_collection
+
+template <typename Point>
+struct flat_linestring : boost::iterator_range<Point const*>
+{
+    using boost::iterator_range<Point const*>::iterator_range;
+};
+
+template <typename Point>
+struct flat_ring : boost::iterator_range<Point const*>
+{
+    using boost::iterator_range<Point const*>::iterator_range;
+};
+
+template <typename Point>
+struct flat_multi_point : boost::iterator_range<Point const*>
+{
+    using boost::iterator_range<Point const*>::iterator_range;
+};
+
+// The exterior ring followed by interior rings
+template <typename Point>
+class flat_polygon
+{
+public:
+    flat_polygon(flat_ring<Point> const* first, flat_ring<Point> const* last)
+        : m_first(first)
+        , m_last(last)
+    {}
+
+    flat_ring<Point> const& outer() const
+    {
+        return *m_first;
+    }
+
+    boost::iterator_range<flat_ring<Point> const*> inners() const
+    {
+        return boost::iterator_range<flat_ring<Point> const*>(m_first + 1, m_last);
+    }
+
+private:
+    flat_ring<Point> const* m_first;
+    flat_ring<Point> const* m_last;
+};
+
+template <typename Point>
+struct flat_multi_linestring : boost::iterator_range<flat_linestring<Point> const*>
+{
+    using boost::iterator_range<flat_linestring<Point> const*>::iterator_range;
+};
+
+template <typename Point>
+struct flat_multi_polygon : boost::iterator_range<flat_polygon<Point> const*>
+{
+    using boost::iterator_range<flat_polygon<Point> const*>::iterator_range;
+};
+
+} // namespace model
+
+namespace detail { namespace flat_geometry_collection {
+
+enum node_type : std::uint32_t
+{
+    point_node,
+    linestring_node,
+    polygon_node,
+    multi_point_node,
+    multi_linestring_node,
+    multi_polygon_node,
+    collection_node
+};
+
+// Element of a GeometryCollection, index is the position in the container of the type
+struct node
+{
+    std::uint32_t type;
+    std::uint32_t index;
+};
+
+// Containers are allocated once with exact sizes so the views can point into them.
+// Elements of every GeometryCollection are stored contiguously in nodes.
+template <typename Point>
+struct storage
+{
+    std::vector<Point> points;
+    std::vector<model::flat_linestring<Point>> linestrings;
+    std::vector<model::flat_ring<Point>> rings;
+    std::vector<model::flat_polygon<Point>> polygons;
+    std::vector<model::flat_multi_point<Point>> multi_points;
+    std::vector<model::flat_multi_linestring<Point>> multi_linestrings;
+    std::vector<model::flat_multi_polygon<Point>> multi_polygons;
+    std::vector<model::flat_collection_view<Point>> collections;
+    std::vector<node> nodes;
+};
+
+template <typename Storage, typename Function>
+inline void visit_node(Function & function, Storage & s, node const& n)
+{
+    switch (n.type)
+    {
+    case point_node: function(s.points[n.index]); break;
+    case linestring_node: function(s.linestrings[n.index]); break;
+    case polygon_node: function(s.polygons[n.index]); break;
+    case multi_point_node: function(s.multi_points[n.index]); break;
+    case multi_linestring_node: function(s.multi_linestrings[n.index]); break;
+    case multi_polygon_node: function(s.multi_polygons[n.index]); break;
+    default: function(s.collections[n.index]); break;
+    }
+}
+
+// Iterator over nodes keeping the storage so the nodes can be visited
+template <typename Storage>
+class iterator
+    : public boost::iterator_facade
+        <
+            iterator<Storage>,
+            node const,
+            boost::random_access_traversal_tag
+        >
+{
+public:
+    iterator() = default;
+
+    iterator(Storage * storage, std::size_t position)
+        : m_storage(storage)
+        , m_position(position)
+    {}
+
+    // Conversion from iterator to const_iterator
+    template
+    <
+        typename S,
+        std::enable_if_t<std::is_convertible<S *, Storage *>::value, int> = 0
+    >
+    iterator(iterator<S> const& other)
+        : m_storage(other.m_storage)
+        , m_position(other.m_position)
+    {}
+
+    Storage & storage() const
+    {
+        return *m_storage;
+    }
+
+private:
+    friend class boost::iterator_core_access;
+    template <typename S> friend class iterator;
+
+    node const& dereference() const
+    {
+        return m_storage->nodes[m_position];
+    }
+
+    template <typename S>
+    bool equal(iterator<S> const& other) const
+    {
+        return m_position == other.m_position;
+    }
+
+    void increment() { ++m_position; }
+    void decrement() { --m_position; }
+    void advance(std::ptrdiff_t n) { m_position += n; }
+
+    template <typename S>
+    std::ptrdiff_t distance_to(iterator<S> const& other) const
+    {
+        return std::ptrdiff_t(other.m_position) - std::ptrdiff_t(m_position);
+    }
+
+    Storage * m_storage = nullptr;
+    std::size_t m_position = 0;
+};
+
+struct counts
+{
+    std::size_t points = 0;
+    std::size_t linestrings = 0;
+    std::size_t rings = 0;
+    std::size_t polygons = 0;
+    std::size_t multi_points = 0;
+    std::size_t multi_linestrings = 0;
+    std::size_t multi_polygons = 0;
+    std::size_t collections = 0;
+    std::size_t nodes = 0;
+};
+
+// Counts the sizes of all containers in the first pass and fills them in the second one
+template <typename Point>
+class builder
+{
+public:
+    explicit builder(storage<Point> & s)
+        : m_storage(s)
+    {}
+
+    template <typename Geometry>
+    void apply(Geometry const& geometry)
+    {
+        counts c;
+        count_root(geometry, c, typename tag<Geometry>::type());
+
+        m_storage.points.reserve(c.points);
+        m_storage.linestrings.reserve(c.linestrings);
+        m_storage.rings.reserve(c.rings);
+        m_storage.polygons.reserve(c.polygons);
+        m_storage.multi_points.reserve(c.multi_points);
+        m_storage.multi_linestrings.reserve(c.multi_linestrings);
+        m_storage.multi_polygons.reserve(c.multi_polygons);
+        m_storage.collections.reserve(c.collections);
+        m_storage.nodes.reserve(c.nodes);
+
+        fill_root(geometry, typename tag<Geometry>::type());
+    }
+
+private:
+    // The root is always a GeometryCollection, other Geometries are stored in it
+
+    template <typename Geometry>
+    void count_root(Geometry const& geometry, counts & c, dynamic_geometry_tag)
+    {
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            this->count_root(g, c, typename tag<util::remove_cref_t<decltype(g)>>::type());
+        }, geometry);
+    }
+    template <typename Geometry>
+    void count_root(Geometry const& geometry, counts & c, geometry_collection_tag)
+    {
+        count(geometry, c, geometry_collection_tag());
+    }
+    template <typename Geometry, typename Tag>
+    void count_root(Geometry const& geometry, counts & c, Tag)
+    {
+        c.collections += 1;
+        c.nodes += 1;
+        count(geometry, c, Tag());
+    }
+
+    template <typename Geometry>
+    void fill_root(Geometry const& geometry, dynamic_geometry_tag)
+    {
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            this->fill_root(g, typename tag<util::remove_cref_t<decltype(g)>>::type());
+        }, geometry);
+    }
+    template <typename Geometry>
+    void fill_root(Geometry const& geometry, geometry_collection_tag)
+    {
+        fill(geometry, geometry_collection_tag());
+    }
+    template <typename Geometry, typename Tag>
+    void fill_root(Geometry const& geometry, Tag)
+    {
+        m_storage.collections.emplace_back(&m_storage, 0, 1);
+        m_storage.nodes.resize(1);
+        m_storage.nodes[0] = fill(geometry, Tag());
+    }
+
+    template <typename Geometry>
+    static void count(Geometry const& , counts & c, point_tag)
+    {
+        c.points += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, linestring_tag)
+    {
+        c.points += boost::size(geometry);
+        c.linestrings += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, polygon_tag)
+    {
+        c.points += boost::size(exterior_ring(geometry));
+        c.rings += 1;
+        for (auto const& ring : interior_rings(geometry))
+        {
+            c.points += boost::size(ring);
+            c.rings += 1;
+        }
+        c.polygons += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, multi_point_tag)
+    {
+        c.points += boost::size(geometry);
+        c.multi_points += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, multi_linestring_tag)
+    {
+        for (auto const& linestring : geometry)
+        {
+            count(linestring, c, linestring_tag());
+        }
+        c.multi_linestrings += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, multi_polygon_tag)
+    {
+        for (auto const& polygon : geometry)
+        {
+            count(polygon, c, polygon_tag());
+        }
+        c.multi_polygons += 1;
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, dynamic_geometry_tag)
+    {
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            count(g, c, typename tag<util::remove_cref_t<decltype(g)>>::type());
+        }, geometry);
+    }
+    template <typename Geometry>
+    static void count(Geometry const& geometry, counts & c, geometry_collection_tag)
+    {
+        c.collections += 1;
+        c.nodes += boost::size(geometry);
+        for (auto it = boost::begin(geometry); it != boost::end(geometry); ++it)
+        {
+            traits::visit_iterator<Geometry>::apply([&](auto const& g)
+            {
+                count(g, c, typename tag<util::remove_cref_t<decltype(g)>>::type());
+            }, it);
+        }
+    }
+
+    template <typename Geometry>
+    node fill(Geometry const& geometry, point_tag)
+    {
+        return node{ point_node, push_point(geometry) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, linestring_tag)
+    {
+        return node{ linestring_node, push_linestring(geometry) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, polygon_tag)
+    {
+        return node{ polygon_node, push_polygon(geometry) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, multi_point_tag)
+    {
+        Point const* first = push_points(geometry);
+        m_storage.multi_points.emplace_back(first, end_of(m_storage.points));
+        return node{ multi_point_node, last_index(m_storage.multi_points) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, multi_linestring_tag)
+    {
+        std::size_t const first = m_storage.linestrings.size();
+        for (auto const& linestring : geometry)
+        {
+            push_linestring(linestring);
+        }
+        m_storage.multi_linestrings.emplace_back(at(m_storage.linestrings, first),
+                                                 end_of(m_storage.linestrings));
+        return node{ multi_linestring_node, last_index(m_storage.multi_linestrings) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, multi_polygon_tag)
+    {
+        std::size_t const first = m_storage.polygons.size();
+        for (auto const& polygon : geometry)
+        {
+            push_polygon(polygon);
+        }
+        m_storage.multi_polygons.emplace_back(at(m_storage.polygons, first),
+                                              end_of(m_storage.polygons));
+        return node{ multi_polygon_node, last_index(m_storage.multi_polygons) };
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, dynamic_geometry_tag)
+    {
+        node result;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = this->fill(g, typename tag<util::remove_cref_t<decltype(g)>>::type());
+        }, geometry);
+        return result;
+    }
+    template <typename Geometry>
+    node fill(Geometry const& geometry, geometry_collection_tag)
+    {
+        // Elements are stored contiguously, nested GeometryCollections after them
+        std::size_t const index = m_storage.collections.size();
+        std::size_t const first = m_storage.nodes.size();
+        std::size_t const last = first + boost::size(geometry);
+        m_storage.collections.emplace_back(&m_storage, first, last);
+        m_storage.nodes.resize(last);
+        std::size_t i = first;
+        for (auto it = boost::begin(geometry); it != boost::end(geometry); ++it, ++i)
+        {
+            traits::visit_iterator<Geometry>::apply([&](auto const& g)
+            {
+                m_storage.nodes[i] = this->fill(g, typename tag<util::remove_cref_t<decltype(g)>>::type());
+            }, it);
+        }
+        return node{ collection_node, std::uint32_t(index) };
+    }
+
+    template <typename SourcePoint>
+    std::uint32_t push_point(SourcePoint const& source)
+    {
+        Point point;
+        geometry::convert(source, point);
+        m_storage.points.push_back(point);
+        return last_index(m_storage.points);
+    }
+
+    template <typename Range>
+    Point const* push_points(Range const& range)
+    {
+        std::size_t const first = m_storage.points.size();
+        for (auto const& point : range)
+        {
+            push_point(point);
+        }
+        return at(m_storage.points, first);
+    }
+
+    template <typename Linestring>
+    std::uint32_t push_linestring(Linestring const& linestring)
+    {
+        Point const* first = push_points(linestring);
+        m_storage.linestrings.emplace_back(first, end_of(m_storage.points));
+        return last_index(m_storage.linestrings);
+    }
+
+    template <typename Ring>
+    void push_ring(Ring const& ring)
+    {
+        Point const* first = push_points(ring);
+        m_storage.rings.emplace_back(first, end_of(m_storage.points));
+    }
+
+    template <typename Polygon>
+    std::uint32_t push_polygon(Polygon const& polygon)
+    {
+        std::size_t const first = m_storage.rings.size();
+        push_ring(exterior_ring(polygon));
+        for (auto const& ring : interior_rings(polygon))
+        {
+            push_ring(ring);
+        }
+        m_storage.polygons.emplace_back(at(m_storage.rings, first),
+                                        end_of(m_storage.rings));
+        return last_index(m_storage.polygons);
+    }
+
+    template <typename Container>
+    static auto at(Container const& container, std::size_t i)
+    {
+        return container.data() + i;
+    }
+
+    template <typename Container>
+    static auto end_of(Container const& container)
+    {
+        return container.data() + container.size();
+    }
+
+    template <typename Container>
+    static std::uint32_t last_index(Container const& container)
+    {
+        return std::uint32_t(container.size() - 1);
+    }
+
+    storage<Point> & m_storage;
+};
+
+}} // namespace detail::flat_geometry_collection
+
+namespace model {
+
+// Nested GeometryCollection stored in flat_geometry_collection
+template <typename Point>
+class flat_collection_view
+{
+    using storage_t = geometry::detail::flat_geometry_collection::storage<Point>;
+
+public:
+    using value_type = geometry::detail::flat_geometry_collection::node;
+    using size_type = std::size_t;
+    using iterator = geometry::detail::flat_geometry_collection::iterator<storage_t>;
+    using const_iterator = geometry::detail::flat_geometry_collection::iterator<storage_t const>;
+
+    flat_collection_view(storage_t * storage, std::size_t first, std::size_t last)
+        : m_storage(storage)
+        , m_first(first)
+        , m_last(last)
+    {}
+
+    iterator begin() { return iterator(m_storage, m_first); }
+    iterator end() { return iterator(m_storage, m_last); }
+    const_iterator begin() const { return const_iterator(m_storage, m_first); }
+    const_iterator end() const { return const_iterator(m_storage, m_last); }
+
+    size_type size() const { return m_last - m_first; }
+    bool empty() const { return m_first == m_last; }
+
+private:
+    storage_t * m_storage;
+    std::size_t m_first;
+    std::size_t m_last;
+};
+
+// Immutable GeometryCollection stored in a few contiguous containers: nodes of all
+// GeometryCollections with type tags and indexes, coordinates of all Geometries and
+// views of Geometries pointing into them. It can be built from any Geometry including
+// dynamic geometries and nested GeometryCollections of any registered type, e.g.:
+//     model::flat_geometry_collection<point_t> flat(gc);
+//     visit_breadth_first(f, flat);
+// Geometries are visited as Point, flat_linestring, flat_polygon, flat_multi_point,
+// flat_multi_linestring, flat_multi_polygon and flat_collection_view.
+// NOTE: Coordinates are copied as they are, so rings of polygons are expected to be
+//   closed and clockwise like in model::polygon by default.
+template <typename Point>
+class flat_geometry_collection
+{
+    using storage_t = geometry::detail::flat_geometry_collection::storage<Point>;
+    using view_t = flat_collection_view<Point>;
+
+public:
+    using value_type = typename view_t::value_type;
+    using size_type = std::size_t;
+    using iterator = typename view_t::iterator;
+    using const_iterator = typename view_t::const_iterator;
+
+    flat_geometry_collection()
+        : m_storage(new storage_t())
+    {
+        m_storage->collections.emplace_back(m_storage.get(), 0, 0);
+    }
+
+    template
+    <
+        typename Geometry,
+        std::enable_if_t<! std::is_same<Geometry, flat_geometry_collection>::value, int> = 0
+    >
+    explicit flat_geometry_collection(Geometry const& source)
+        : m_storage(new storage_t())
+    {
+        geometry::detail::flat_geometry_collection::builder<Point>(*m_storage).apply(source);
+    }
+
+    // Views can't be copied, the copy is built from scratch
+    flat_geometry_collection(flat_geometry_collection const& other)
+        : m_storage(new storage_t())
+    {
+        geometry::detail::flat_geometry_collection::builder<Point>(*m_storage).apply(other);
+    }
+
+    flat_geometry_collection(flat_geometry_collection && other) = default;
+
+    flat_geometry_collection & operator=(flat_geometry_collection const& other)
+    {
+        flat_geometry_collection(other).swap(*this);
+        return *this;
+    }
+
+    flat_geometry_collection & operator=(flat_geometry_collection && other) = default;
+
+    void swap(flat_geometry_collection & other) noexcept
+    {
+        m_storage.swap(other.m_storage);
+    }
+
+    // NOTE: Moved-from collection is empty
+    iterator begin() { return m_storage ? root().begin() : iterator(); }
+    iterator end() { return m_storage ? root().end() : iterator(); }
+    const_iterator begin() const { return m_storage ? root().begin() : const_iterator(); }
+    const_iterator end() const { return m_storage ? root().end() : const_iterator(); }
+
+    size_type size() const { return m_storage ? root().size() : 0; }
+    bool empty() const { return size() == 0; }
+
+    // Number of nodes and of points of all Geometries
+    size_type num_nodes() const { return m_storage ? m_storage->nodes.size() : 0; }
+    size_type num_points() const { return m_storage ? m_storage->points.size() : 0; }
+
+private:
+    view_t & root() { return m_storage->collections.front(); }
+    view_t const& root() const { return m_storage->collections.front(); }
+
+    std::unique_ptr<storage_t> m_storage;
+};
+
+} // namespace model
+
+namespace traits {
+
+template <typename Point>
+struct tag<model::flat_linestring<Point>>
+{
+    typedef linestring_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_ring<Point>>
+{
+    typedef ring_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_multi_point<Point>>
+{
+    typedef multi_point_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_polygon<Point>>
+{
+    typedef polygon_tag type;
+};
+
+template <typename Point>
+struct ring_const_type<model::flat_polygon<Point>>
+{
+    typedef model::flat_ring<Point> const& type;
+};
+
+template <typename Point>
+struct ring_mutable_type<model::flat_polygon<Point>>
+{
+    typedef model::flat_ring<Point> const& type;
+};
+
+template <typename Point>
+struct interior_const_type<model::flat_polygon<Point>>
+{
+    typedef boost::iterator_range<model::flat_ring<Point> const*> type;
+};
+
+template <typename Point>
+struct interior_mutable_type<model::flat_polygon<Point>>
+{
+    typedef boost::iterator_range<model::flat_ring<Point> const*> type;
+};
+
+template <typename Point>
+struct exterior_ring<model::flat_polygon<Point>>
+{
+    static model::flat_ring<Point> const& get(model::flat_polygon<Point> const& p)
+    {
+        return p.outer();
+    }
+};
+
+template <typename Point>
+struct interior_rings<model::flat_polygon<Point>>
+{
+    static boost::iterator_range<model::flat_ring<Point> const*> get(model::flat_polygon<Point> const& p)
+    {
+        return p.inners();
+    }
+};
+
+template <typename Point>
+struct tag<model::flat_multi_linestring<Point>>
+{
+    typedef multi_linestring_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_multi_polygon<Point>>
+{
+    typedef multi_polygon_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_collection_view<Point>>
+{
+    typedef geometry_collection_tag type;
+};
+
+template <typename Point>
+struct tag<model::flat_geometry_collection<Point>>
+{
+    typedef geometry_collection_tag type;
+};
+
+template <typename Point>
+struct geometry_types<model::flat_collection_view<Point>>
+{
+    typedef util::type_sequence
+        <
+            Point,
+            model::flat_linestring<Point>,
+            model::flat_polygon<Point>,
+            model::flat_multi_point<Point>,
+            model::flat_multi_linestring<Point>,
+            model::flat_multi_polygon<Point>,
+            model::flat_collection_view<Point>
+        > type;
+};
+
+template <typename Point>
+struct geometry_types<model::flat_geometry_collection<Point>>
+    : geometry_types<model::flat_collection_view<Point>>
+{};
+
+template <typename Point>
+struct visit_iterator<model::flat_collection_view<Point>>
+{
+    template <typename Function, typename Iterator>
+    static void apply(Function && function, Iterator iterator)
+    {
+        geometry::detail::flat_geometry_collection::visit_node(function, iterator.storage(), *iterator);
+    }
+};
+
+template <typename Point>
+struct visit_iterator<model::flat_geometry_collection<Point>>
+    : visit_iterator<model::flat_collection_view<Point>>
+{};
+
+} // namespace traits
+
+}} // namespace boost::geometry
+
+#endif // FLAT_GEOMETRY_COLLECTION_HPP
@@ -1,10 +1,22 @@
 #ifndef GEOMETRY_HPP
 #define GEOMETRY_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/geometries.hpp>
 #include <boost/geometry/geometries/register/point.hpp>
 #include <boost/geometry/geometries/register/linestring.hpp>
+#include <boost/range/adaptor/indirected.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/type_traits/type_identity.hpp>
 
 namespace boost { namespace geometry {
 
@@ -15,11 +27,43 @@ struct dynamic_geometry_tag {};
 //   In fact since now we can move() StaticGeometries then an algorithm returning a GC
 //   would probably use TupledGeometry internally and then it would simply be returned
 //   or StaticGeometries would be moved to GeometryCollection.
-// NOTE: Right now these are not used. TupledGeometry is a tuple type containing StaticGeometries.
-//   They could be a separate Geometries kinds but then for consistency access would have to be
-//   implemented as traits as opposed to utilities that we have now.
+// NOTE: TupledGeometry is a tuple of StaticGeometries of different types, see
+//   model::tupled_geometry. The types are known at compile time so it's traversed
+//   without dispatching. It's not a GeometryCollection but its StaticGeometries can be
+//   moved into one with range::append.
 //struct tuple_geometry_tag {};
-//struct tupled_geometry_tag {};
+struct tupled_geometry_tag {};
+
+// NOTE: geometry_collection_tag is derived from multi_tag but GeometryCollections are
+//   not ranges of StaticGeometries of one type so algorithms casting tags to multi_tag,
+//   e.g. clear and num_points, are dispatched for geometry_collection_tag instead.
+template <>
+struct tag_cast<geometry_collection_tag, multi_tag>
+{
+    typedef geometry_collection_tag type;
+};
+
+// NOTE: Ids of DynamicGeometries and GeometryCollections are greater than ids of
+//   StaticGeometries so they're always passed as the second geometry into algorithms
+//   reversing the arguments, e.g. distance.
+// NOTE: DynamicGeometries and GeometryCollections don't have one topological
+//   dimension. -1 is defined so strategies can be selected for them.
+namespace core_dispatch
+{
+
+template <>
+struct geometry_id<geometry_collection_tag> : boost::mpl::int_<95> {};
+
+template <>
+struct geometry_id<dynamic_geometry_tag> : boost::mpl::int_<96> {};
+
+template <>
+struct top_dim<geometry_collection_tag> : boost::mpl::int_<-1> {};
+
+template <>
+struct top_dim<dynamic_geometry_tag> : boost::mpl::int_<-1> {};
+
+} // namespace core_dispatch
 
 namespace util
 {
@@ -34,9 +78,296 @@ struct is_geometry_collection
     : std::is_same<geometry_collection_tag, typename tag<T>::type>
 {};
 
+template <typename T>
+struct is_tupled_geometry
+    : std::is_same<tupled_geometry_tag, typename tag<T>::type>
+{};
+
 } // namespace util
 
 
+namespace traits {
+
+template <typename Geometry>
+struct geometry_types;
+
+// Index of the type of the geometry currently stored in DynamicGeometry within
+// geometry_types or the size of geometry_types if the geometry is not there, e.g.:
+//     template <>
+//     struct which<MyGeometry>
+//     {
+//         static std::size_t apply(MyGeometry const& g) { return g.ptr->which(); }
+//     };
+// NOTE: This is optional. If it's specialized together with unsafe_get then
+//   visit doesn't have to be specialized and one or two DynamicGeometries are
+//   visited with one indirect call, see visit below.
+template <typename DynamicGeometry>
+struct which
+{};
+
+// Geometry of I-th type in geometry_types stored in DynamicGeometry, e.g.:
+//     template <>
+//     struct unsafe_get<MyGeometry>
+//     {
+//         template <std::size_t I, typename Geometry>
+//         static auto & apply(Geometry & g) { ... }
+//     };
+// The geometry has to be const if Geometry is const.
+// NOTE: Called only with the index returned by which.
+template <typename DynamicGeometry>
+struct unsafe_get
+{};
+
+} // namespace traits
+
+namespace detail { namespace visit_table
+{
+
+template <typename DynamicGeometry, typename Enable = void>
+struct has_type_index
+    : std::false_type
+{};
+
+template <typename DynamicGeometry>
+struct has_type_index
+    <
+        DynamicGeometry,
+        decltype(void(traits::which<DynamicGeometry>::apply(std::declval<DynamicGeometry const&>())))
+    >
+    : std::true_type
+{};
+
+template <typename DynamicGeometry>
+using types_size = util::sequence_size<typename traits::geometry_types<DynamicGeometry>::type>;
+
+// Table of handlers, one for each type in TypeSequence, calling the function with
+// the object cast to the type of the index, e.g. for polymorphic geometries:
+//     visit_derived<geometry_types<MyGColl>::type>::apply(function, ptr->which(), *ptr);
+// NOTE: The index has to be the position of the type in TypeSequence, nothing is
+//   called if it's out of range.
+template
+<
+    typename TypeSequence,
+    typename IndexSequence = std::make_index_sequence<util::sequence_size<TypeSequence>::value>
+>
+struct visit_derived;
+
+template <typename TypeSequence, std::size_t ...Is>
+struct visit_derived<TypeSequence, std::index_sequence<Is...>>
+{
+    template <typename Function, typename Base>
+    static void apply(Function & function, std::size_t index, Base & base)
+    {
+        using handler_t = void (*)(Function &, Base &);
+        static const handler_t handlers[] = { &call<Is, Function, Base>... };
+
+        if (index < sizeof...(Is))
+        {
+            handlers[index](function, base);
+        }
+    }
+
+private:
+    template <std::size_t I, typename Function, typename Base>
+    static void call(Function & function, Base & base)
+    {
+        using geometry_t = typename util::sequence_element<I, TypeSequence>::type;
+        function(static_cast<util::transcribe_const_t<Base, geometry_t> &>(base));
+    }
+};
+
+// Hash of the address of a type_info object used as a key of open addressing tables
+inline std::size_t type_info_hash(std::type_info const* type)
+{
+    std::uintptr_t h = reinterpret_cast<std::uintptr_t>(type);
+    h ^= h >> 17;
+    h *= 0x9E3779B1u;
+    h ^= h >> 15;
+    return static_cast<std::size_t>(h);
+}
+
+// Index of the dynamic type of a polymorphic object in geometry_types, cached for
+// each dynamic type so e.g. double dispatch of visitor-pattern hierarchies is done
+// only once per type:
+//     return cached_type_index<MyGeometry>::apply(*ptr, [&]() { return find(*ptr); });
+// The find function is called if the dynamic type is not in the cache. The cache
+// is thread-local so no synchronization is needed.
+// NOTE: The same type may have several type_info objects, e.g. in shared libraries,
+//   and types derived from the types in geometry_types may be used so the number of
+//   cached type_infos is not known. The table grows when it's half full.
+template <typename DynamicGeometry>
+struct cached_type_index
+{
+    template <typename Base, typename Find>
+    static std::size_t apply(Base const& base, Find && find)
+    {
+        thread_local cache c;
+
+        std::type_info const* const type = &typeid(base);
+        std::size_t const mask = c.entries.size() - 1;
+        for (std::size_t i = type_info_hash(type) & mask; c.entries[i].type != nullptr; i = (i + 1) & mask)
+        {
+            if (c.entries[i].type == type)
+            {
+                return c.entries[i].index;
+            }
+        }
+
+        std::size_t const index = find();
+        c.insert(type, index);
+        return index;
+    }
+
+private:
+    struct entry
+    {
+        std::type_info const* type = nullptr;
+        std::size_t index = 0;
+    };
+
+    // Power of 2 number of entries, at least half empty
+    struct cache
+    {
+        cache()
+        {
+            std::size_t size = 1;
+            while (size < 2 * types_size<DynamicGeometry>::value)
+            {
+                size *= 2;
+            }
+            entries.resize(size);
+        }
+
+        void insert(std::type_info const* type, std::size_t index)
+        {
+            if (2 * (count + 1) > entries.size())
+            {
+                std::vector<entry> old(entries.size() * 2);
+                old.swap(entries);
+                for (entry const& e : old)
+                {
+                    if (e.type != nullptr)
+                    {
+                        place(e);
+                    }
+                }
+            }
+            place(entry{ type, index });
+            ++count;
+        }
+
+        void place(entry const& e)
+        {
+            std::size_t const mask = entries.size() - 1;
+            std::size_t i = type_info_hash(e.type) & mask;
+            while (entries[i].type != nullptr)
+            {
+                i = (i + 1) & mask;
+            }
+            entries[i] = e;
+        }
+
+        std::vector<entry> entries;
+        std::size_t count = 0;
+    };
+};
+
+// Table of handlers, one for each type in geometry_types, indexed with the type
+// index returned by which so the function is called with one indirect call.
+template
+<
+    typename DynamicGeometry,
+    typename IndexSequence = std::make_index_sequence<types_size<DynamicGeometry>::value>
+>
+struct visit_one;
+
+template <typename DynamicGeometry, std::size_t ...Is>
+struct visit_one<DynamicGeometry, std::index_sequence<Is...>>
+{
+    template <typename Function, typename Geometry>
+    static void apply(Function & function, Geometry & geometry)
+    {
+        using handler_t = void (*)(Function &, Geometry &);
+        static const handler_t handlers[] = { &call<Is, Function, Geometry>... };
+
+        std::size_t const index = traits::which<DynamicGeometry>::apply(geometry);
+        if (index < sizeof...(Is))
+        {
+            handlers[index](function, geometry);
+        }
+    }
+
+private:
+    template <std::size_t I, typename Function, typename Geometry>
+    static void call(Function & function, Geometry & geometry)
+    {
+        function(traits::unsafe_get<DynamicGeometry>::template apply<I>(geometry));
+    }
+};
+
+// Table of N*M handlers, one for each pair of types, indexed with both type
+// indexes at once so the function is called with one indirect call.
+template
+<
+    typename DynamicGeometry1, typename DynamicGeometry2,
+    typename IndexSequence = std::make_index_sequence
+        <
+            types_size<DynamicGeometry1>::value * types_size<DynamicGeometry2>::value
+        >
+>
+struct visit_two;
+
+template <typename DynamicGeometry1, typename DynamicGeometry2, std::size_t ...Is>
+struct visit_two<DynamicGeometry1, DynamicGeometry2, std::index_sequence<Is...>>
+{
+    static const std::size_t N = types_size<DynamicGeometry1>::value;
+    static const std::size_t M = types_size<DynamicGeometry2>::value;
+
+    template <typename Function, typename Geometry1, typename Geometry2>
+    static void apply(Function & function, Geometry1 & geometry1, Geometry2 & geometry2)
+    {
+        using handler_t = void (*)(Function &, Geometry1 &, Geometry2 &);
+        static const handler_t handlers[] = { &call<Is, Function, Geometry1, Geometry2>... };
+
+        std::size_t const i1 = traits::which<DynamicGeometry1>::apply(geometry1);
+        std::size_t const i2 = traits::which<DynamicGeometry2>::apply(geometry2);
+        if (i1 < N && i2 < M)
+        {
+            handlers[i1 * M + i2](function, geometry1, geometry2);
+        }
+    }
+
+private:
+    template <std::size_t I, typename Function, typename Geometry1, typename Geometry2>
+    static void call(Function & function, Geometry1 & geometry1, Geometry2 & geometry2)
+    {
+        function(traits::unsafe_get<DynamicGeometry1>::template apply<I / M>(geometry1),
+                 traits::unsafe_get<DynamicGeometry2>::template apply<I % M>(geometry2));
+    }
+};
+
+}} // namespace detail::visit_table
+
+namespace detail
+{
+
+template <typename Range, typename Enable = void>
+struct has_reserve
+    : std::false_type
+{};
+
+template <typename Range>
+struct has_reserve
+    <
+        Range,
+        decltype(void(std::declval<Range &>().reserve(std::size_t(0))),
+                 void(std::size_t(std::declval<Range const&>().capacity())))
+    >
+    : std::true_type
+{};
+
+} // namespace detail
+
 namespace traits {
 
 // TODO: Alternatives:
@@ -56,20 +387,62 @@ struct visit
         DynamicGeometries...);
 };
 
-// By default call 1-parameter visit for each geometry
+// By default use the table of handlers if the DynamicGeometry defines which and
+// unsafe_get so the geometry is visited without testing the types one by one
+template <typename DynamicGeometry>
+struct visit<DynamicGeometry>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(
+        (detail::visit_table::has_type_index<DynamicGeometry>::value),
+        "Not implemented for this DynamicGeometry type.",
+        DynamicGeometry);
+
+    template <typename Function, typename Geometry>
+    static void apply(Function && function, Geometry & geometry)
+    {
+        detail::visit_table::visit_one<DynamicGeometry>::apply(function, geometry);
+    }
+};
+
+// By default use the table of handlers if both DynamicGeometries define which and
+// unsafe_get, otherwise call 1-parameter visit for each geometry
 template <typename DynamicGeometry1, typename DynamicGeometry2>
 struct visit<DynamicGeometry1, DynamicGeometry2>
 {
     template <typename Function, typename Variant1, typename Variant2>
     static void apply(Function && function, Variant1 & variant1, Variant2 & variant2)
+    {
+        apply(function, variant1, variant2,
+              std::integral_constant
+                <
+                    bool,
+                    detail::visit_table::has_type_index<DynamicGeometry1>::value
+                 && detail::visit_table::has_type_index<DynamicGeometry2>::value
+                >());
+    }
+
+private:
+    template <typename Function, typename Variant1, typename Variant2>
+    static void apply(Function & function, Variant1 & variant1, Variant2 & variant2,
+                      std::true_type /*has_type_index*/)
+    {
+        detail::visit_table::visit_two
+            <
+                DynamicGeometry1, DynamicGeometry2
+            >::apply(function, variant1, variant2);
+    }
+
+    template <typename Function, typename Variant1, typename Variant2>
+    static void apply(Function & function, Variant1 & variant1, Variant2 & variant2,
+                      std::false_type /*has_type_index*/)
     {
         visit<util::remove_cref_t<Variant1>>::apply([&](auto & g1)
         {
             visit<util::remove_cref_t<Variant2>>::apply([&](auto & g2)
             {
                 function(g1, g2);
-            }, variant1);
-        }, variant2);
+            }, variant2);
+        }, variant1);
     }
 };
 
@@ -86,6 +459,36 @@ struct visit_iterator
     }
 };
 
+// Defines value true if the DynamicGeometry or GeometryCollection passes temporary
+// StaticGeometries into visited functions, e.g. views created during traversal,
+// instead of references to StaticGeometries stored in it, e.g.:
+//     template <>
+//     struct visit_yields_temporaries<MyView> : std::true_type {};
+// NOTE: Algorithms storing references to visited StaticGeometries, e.g.
+//   collection_rtree, distance, visit_pairwise and visit_grouped, can't be used for
+//   such Geometry unless they're specialized for it.
+template <typename Geometry>
+struct visit_yields_temporaries
+    : std::false_type
+{};
+
+// Defines value true if the Geometry stores StaticGeometries of each type contiguously
+// so visit_grouped passes its containers without traversing it, e.g.:
+//     template <>
+//     struct grouped_storage<MyCollection> : std::true_type {};
+// Then algorithms processing geometries of one type in a loop use visit_grouped,
+// otherwise they use visit_depth_first.
+template <typename Geometry, typename Tag = typename geometry::tag<Geometry>::type>
+struct grouped_storage
+    : std::false_type
+{};
+
+// StaticGeometries stored in TupledGeometry are passed as ranges of one geometry
+template <typename Geometry>
+struct grouped_storage<Geometry, tupled_geometry_tag>
+    : std::true_type
+{};
+
 template <typename Geometry, typename Tag = typename geometry::tag<Geometry>::type>
 struct geometry_types_impl
 {
@@ -97,7 +500,7 @@ struct geometry_types_impl
 // By default treat GeometryCollection as a range of DynamicGeometries
 template <typename Geometry>
 struct geometry_types_impl<Geometry, geometry_collection_tag>
-    : geometry_types_impl<typename boost::range_value<Geometry>::type>
+    : geometry_types<typename boost::range_value<Geometry>::type>
 {};
 
 // DynamicGeometry or GeometryCollection
@@ -106,8 +509,17 @@ struct geometry_types
     : geometry_types_impl<Geometry>
 {};
 
-// TODO: also implement push_back taking r-value reference
-
+// NOTE: Geometries passed as r-values have to be moved, e.g.:
+//     template <>
+//     struct emplace_back<MyGColl>
+//     {
+//         template <typename Geometry>
+//         static void apply(MyGColl & range, Geometry && geometry)
+//         {
+//             using geometry_t = util::remove_cref_t<Geometry>;
+//             range.emplace_back(new geometry_t(std::forward<Geometry>(geometry)));
+//         }
+//     };
 template <typename Range>
 struct emplace_back
 {
@@ -122,6 +534,34 @@ struct emplace_back
     }
 };
 
+// Reserves space for count more elements before they're added with emplace_back,
+// e.g. by range::append. By default reserve() is called if the Range defines it
+// together with capacity(), only if the elements don't fit in the current capacity.
+// The capacity is then at least doubled so appending a few elements at a time
+// keeps the amortized constant time of emplace_back.
+template <typename Range>
+struct reserve
+{
+    static inline void apply(typename rvalue_type<Range>::type range, std::size_t count)
+    {
+        apply(range, count, detail::has_reserve<Range>());
+    }
+
+private:
+    static inline void apply(Range & range, std::size_t count, std::true_type /*has_reserve*/)
+    {
+        std::size_t const required = boost::size(range) + count;
+        std::size_t const capacity = range.capacity();
+        if (required > capacity)
+        {
+            range.reserve((std::max)(required, 2 * capacity));
+        }
+    }
+
+    static inline void apply(Range & , std::size_t , std::false_type /*has_reserve*/)
+    {}
+};
+
 } // namespace traits
 
 }} // namespace boost::geometry
@@ -140,9 +580,38 @@ namespace boost { namespace geometry { namespace traits { \
 
 namespace boost { namespace geometry {
 
+namespace model {
+
+template <typename ...Geometries>
+class tupled_geometry;
+
+} // namespace model
+
 namespace range {
 
-// TODO: also implement push_back taking r-value reference
+namespace detail
+{
+
+template <typename Range, typename Iterator>
+inline void reserve(Range & , Iterator , Iterator , std::input_iterator_tag)
+{}
+
+template <typename Range, typename Iterator>
+inline void reserve(Range & rng, Iterator first, Iterator last, std::forward_iterator_tag)
+{
+    geometry::traits::reserve<Range>::apply(rng, std::size_t(std::distance(first, last)));
+}
+
+template <typename Range, typename TupledGeometry, std::size_t ...Is>
+inline void append_tupled(Range & rng, TupledGeometry && tupled, std::index_sequence<Is...>)
+{
+    geometry::traits::reserve<Range>::apply(rng, sizeof...(Is));
+    int const dummy[] = { 0, (geometry::traits::emplace_back<Range>::apply(
+                                  rng, std::get<Is>(std::forward<TupledGeometry>(tupled))), 0)... };
+    boost::ignore_unused(dummy);
+}
+
+} // namespace detail
 
 template <typename Range, typename ...Args>
 inline void emplace_back(Range & rng, Args&&... args)
@@ -150,6 +619,49 @@ inline void emplace_back(Range & rng, Args&&... args)
     geometry::traits::emplace_back<Range>::apply(rng, std::forward<Args>(args)...);
 }
 
+// Moves the element into the GeometryCollection, push_back taking const reference
+// is defined in Boost.Geometry
+template
+<
+    typename Range,
+    std::enable_if_t<util::is_geometry_collection<Range>::value, int> = 0
+>
+inline void push_back(Range & rng, typename boost::range_value<Range>::type && value)
+{
+    geometry::traits::emplace_back<Range>::apply(rng, std::move(value));
+}
+
+// Adds geometries from [first, last) to the GeometryCollection with emplace_back.
+// The space is reserved once for forward iterators and the geometries are moved
+// for move iterators, e.g.:
+//     range::append(gc, std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+template <typename Range, typename Iterator>
+inline void append(Range & rng, Iterator first, Iterator last)
+{
+    detail::reserve(rng, first, last,
+                    typename std::iterator_traits<Iterator>::iterator_category());
+    for (; first != last; ++first)
+    {
+        geometry::traits::emplace_back<Range>::apply(rng, *first);
+    }
+}
+
+// Adds StaticGeometries stored in the TupledGeometry to the GeometryCollection in
+// the order of the tuple. The StaticGeometries are moved if the TupledGeometry is
+// passed as r-value, e.g.:
+//     range::append(gc, std::move(tupled));
+template
+<
+    typename Range, typename TupledGeometry,
+    std::enable_if_t<util::is_tupled_geometry<util::remove_cref_t<TupledGeometry>>::value, int> = 0
+>
+inline void append(Range & rng, TupledGeometry && tupled)
+{
+    using types_t = typename geometry::traits::geometry_types<util::remove_cref_t<TupledGeometry>>::type;
+    detail::append_tupled(rng, std::forward<TupledGeometry>(tupled),
+                          std::make_index_sequence<util::sequence_size<types_t>::value>());
+}
+
 } // namespace range
 
 namespace model {
@@ -176,6 +688,13 @@ public:
     geometry_collection(std::initializer_list<DynamicGeometry> l)
         : base_type(l.begin(), l.end())
     {}
+
+    // StaticGeometries are moved from the TupledGeometry
+    template <typename ...Geometries>
+    explicit geometry_collection(tupled_geometry<Geometries...> && tupled)
+    {
+        range::append(*this, std::move(tupled));
+    }
 };
 
 } // namespace model
@@ -197,66 +716,361 @@ struct tag<model::geometry_collection<DynamicGeometry, Container, Allocator>>
 
 namespace detail {
 
-//template <typename T>
-//using enable_if_geometry_t = std::enable_if_t<boost::geometry::util::is_geometry<std::remove_const_t<T>>::value, int>;
-
-//template <typename T>
-//using enable_if_not_geometry_t = std::enable_if_t<boost::geometry::util::is_geometry<std::remove_const_t<T>>::value, int>;
-
-} // namespace detail
-
-namespace dispatch
+template <typename TypeSequence>
+struct sequence_find_geometry_collection
 {
+    typedef void type;
+};
 
-template <typename Geometry, bool IsConst>
-struct check<Geometry, dynamic_geometry_tag, IsConst>
-    // TODO traits::visit
+template <typename T, typename ...Ts>
+struct sequence_find_geometry_collection<util::type_sequence<T, Ts...>>
+    : std::conditional_t
+        <
+            util::is_geometry_collection<T>::value,
+            boost::type_identity<T>,
+            sequence_find_geometry_collection<util::type_sequence<Ts...>>
+        >
 {};
 
-template <typename Geometry, bool IsConst>
-struct check<Geometry, geometry_collection_tag, IsConst>
-    // TODO range of dynamic geometries
+// GeometryCollection type stored in GeometryCollection or void if there is none.
+// NOTE: Traversals assume that all nested GeometryCollections have this type.
+template <typename GeometryCollection>
+struct nested_geometry_collection
+    : sequence_find_geometry_collection<typename traits::geometry_types<GeometryCollection>::type>
 {};
 
-template <typename Geometry>
-struct clear<Geometry, dynamic_geometry_tag>
+template <typename TypeSequence>
+struct sequence_find_static_geometry
 {
-    static void apply(Geometry& geometry)
-    {
-        traits::visit<Geometry>::apply([](auto & g)
-        {
-            clear<std::remove_reference_t<decltype(g)>>::apply(g);
-        }, geometry);
-    }
+    typedef void type;
 };
 
-template <typename Geometry>
-struct clear<Geometry, geometry_collection_tag>
-    : detail::clear::collection_clear<Geometry>
+template <typename T, typename ...Ts>
+struct sequence_find_static_geometry<util::type_sequence<T, Ts...>>
+    : std::conditional_t
+        <
+            util::is_geometry_collection<T>::value,
+            sequence_find_static_geometry<util::type_sequence<Ts...>>,
+            boost::type_identity<T>
+        >
 {};
 
-}
+// Index of T in TypeSequence or the size of TypeSequence if it's not there
+template <typename T, typename TypeSequence, std::size_t I = 0>
+struct sequence_index
+    : std::integral_constant<std::size_t, I>
+{};
 
-namespace dispatch
-{
+template <typename T, typename U, typename ...Us, std::size_t I>
+struct sequence_index<T, util::type_sequence<U, Us...>, I>
+    : std::conditional_t
+        <
+            std::is_same<T, U>::value,
+            std::integral_constant<std::size_t, I>,
+            sequence_index<T, util::type_sequence<Us...>, I + 1>
+        >
+{};
 
-template <typename Geometry, typename Tag = typename tag<Geometry>::type>
-struct visit_one
+// FIFO queue storing up to N elements inline. The heap is used only if more
+// elements are pushed at the same time.
+template <typename T, std::size_t N>
+class small_queue
 {
-    template <typename F, typename G>
-    static void apply(F && f, G & g)
+    BOOST_GEOMETRY_STATIC_ASSERT(N > 0 && (N & (N - 1)) == 0,
+        "N has to be a power of 2.", std::integral_constant<std::size_t, N>);
+
+public:
+    small_queue() = default;
+    small_queue(small_queue const&) = delete;
+    small_queue & operator=(small_queue const&) = delete;
+
+    bool empty() const
     {
-        f(g);
+        return m_size == 0;
     }
-};
-
-template <typename Geometry>
-struct visit_one<Geometry, void>
-{
-    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
-        "Not implemented for this Geometry type.",
-        Geometry);
-};
+
+    T const& front() const
+    {
+        return m_data[m_first];
+    }
+
+    void push_back(T const& value)
+    {
+        if (m_size == m_capacity)
+        {
+            grow();
+        }
+        m_data[(m_first + m_size) & (m_capacity - 1)] = value;
+        ++m_size;
+    }
+
+    void pop_front()
+    {
+        m_first = (m_first + 1) & (m_capacity - 1);
+        --m_size;
+    }
+
+private:
+    void grow()
+    {
+        std::unique_ptr<T[]> heap(new T[m_capacity * 2]);
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            heap[i] = m_data[(m_first + i) & (m_capacity - 1)];
+        }
+        m_heap = std::move(heap);
+        m_data = m_heap.get();
+        m_capacity *= 2;
+        m_first = 0;
+    }
+
+    T m_buffer[N];
+    std::unique_ptr<T[]> m_heap;
+    T * m_data = m_buffer;
+    std::size_t m_capacity = N;
+    std::size_t m_first = 0;
+    std::size_t m_size = 0;
+};
+
+// LIFO stack storing up to N elements inline. The heap is used only if more
+// elements are pushed at the same time.
+template <typename T, std::size_t N>
+class small_stack
+{
+public:
+    small_stack() = default;
+    small_stack(small_stack const&) = delete;
+    small_stack & operator=(small_stack const&) = delete;
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    T & back()
+    {
+        return m_data[m_size - 1];
+    }
+
+    void push_back(T const& value)
+    {
+        if (m_size == m_capacity)
+        {
+            grow();
+        }
+        m_data[m_size] = value;
+        ++m_size;
+    }
+
+    void pop_back()
+    {
+        --m_size;
+    }
+
+private:
+    void grow()
+    {
+        std::unique_ptr<T[]> heap(new T[m_capacity * 2]);
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            heap[i] = m_data[i];
+        }
+        m_heap = std::move(heap);
+        m_data = m_heap.get();
+        m_capacity *= 2;
+    }
+
+    T m_buffer[N];
+    std::unique_ptr<T[]> m_heap;
+    T * m_data = m_buffer;
+    std::size_t m_capacity = N;
+    std::size_t m_size = 0;
+};
+
+// True if all types in TypeSequence are different StaticGeometries
+template <typename TypeSequence>
+struct sequence_distinct_static_geometries
+    : std::true_type
+{};
+
+template <typename T, typename ...Ts>
+struct sequence_distinct_static_geometries<util::type_sequence<T, Ts...>>
+    : std::integral_constant
+        <
+            bool,
+            ! std::is_void<typename tag<T>::type>::value
+         && ! util::is_dynamic_geometry<T>::value
+         && ! util::is_geometry_collection<T>::value
+         && ! util::is_tupled_geometry<T>::value
+         && sequence_index<T, util::type_sequence<Ts...>>::value == sizeof...(Ts)
+         && sequence_distinct_static_geometries<util::type_sequence<Ts...>>::value
+        >
+{};
+
+//template <typename T>
+//using enable_if_geometry_t = std::enable_if_t<boost::geometry::util::is_geometry<std::remove_const_t<T>>::value, int>;
+
+//template <typename T>
+//using enable_if_not_geometry_t = std::enable_if_t<boost::geometry::util::is_geometry<std::remove_const_t<T>>::value, int>;
+
+} // namespace detail
+
+namespace model {
+
+// Tuple of StaticGeometries of different types, e.g. the result of an algorithm
+// producing geometries of several types:
+//     tupled_geometry<multi_point, multi_linestring, multi_polygon> result;
+//     std::get<multi_linestring>(result).push_back(ls);
+// The StaticGeometries are stored and accessed as elements of std::tuple.
+template <typename ...Geometries>
+class tupled_geometry
+    : public std::tuple<Geometries...>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(
+        (geometry::detail::sequence_distinct_static_geometries<util::type_sequence<Geometries...>>::value),
+        "Geometries have to be different StaticGeometries.",
+        Geometries...);
+
+public:
+    using std::tuple<Geometries...>::tuple;
+
+    tupled_geometry() = default;
+};
+
+} // namespace model
+
+namespace traits {
+
+template <typename ...Geometries>
+struct tag<model::tupled_geometry<Geometries...>>
+{
+    typedef tupled_geometry_tag type;
+};
+
+template <typename ...Geometries>
+struct geometry_types<model::tupled_geometry<Geometries...>>
+{
+    typedef util::type_sequence<Geometries...> type;
+};
+
+} // namespace traits
+
+namespace core_dispatch
+{
+
+// NOTE: The point type of the first StaticGeometry in geometry_types.
+//   All of them are expected to have the same coordinate system and dimension.
+template <typename Geometry>
+struct point_type<dynamic_geometry_tag, Geometry>
+    : geometry::point_type
+        <
+            typename detail::sequence_find_static_geometry
+                <
+                    typename traits::geometry_types<Geometry>::type
+                >::type
+        >
+{};
+
+template <typename Geometry>
+struct point_type<geometry_collection_tag, Geometry>
+    : geometry::point_type
+        <
+            typename detail::sequence_find_static_geometry
+                <
+                    typename traits::geometry_types<Geometry>::type
+                >::type
+        >
+{};
+
+template <typename Geometry>
+struct point_type<tupled_geometry_tag, Geometry>
+    : geometry::point_type
+        <
+            typename detail::sequence_find_static_geometry
+                <
+                    typename traits::geometry_types<Geometry>::type
+                >::type
+        >
+{};
+
+} // namespace core_dispatch
+
+namespace detail
+{
+
+// Checks the concepts of all StaticGeometries stored in a TupledGeometry
+template <typename TypeSequence, bool IsConst>
+struct check_tupled_geometry;
+
+template <typename ...Geometries, bool IsConst>
+struct check_tupled_geometry<util::type_sequence<Geometries...>, IsConst>
+    : dispatch::check<std::conditional_t<IsConst, Geometries const, Geometries>>...
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(
+        (sequence_distinct_static_geometries<util::type_sequence<Geometries...>>::value),
+        "Geometries have to be different StaticGeometries.",
+        Geometries...);
+};
+
+} // namespace detail
+
+namespace dispatch
+{
+
+template <typename Geometry, bool IsConst>
+struct check<Geometry, dynamic_geometry_tag, IsConst>
+    // TODO traits::visit
+{};
+
+template <typename Geometry, bool IsConst>
+struct check<Geometry, geometry_collection_tag, IsConst>
+    // TODO range of dynamic geometries
+{};
+
+template <typename Geometry, bool IsConst>
+struct check<Geometry, tupled_geometry_tag, IsConst>
+    : detail::check_tupled_geometry<typename traits::geometry_types<util::remove_cref_t<Geometry>>::type, IsConst>
+{};
+
+template <typename Geometry>
+struct clear<Geometry, dynamic_geometry_tag>
+{
+    static void apply(Geometry& geometry)
+    {
+        traits::visit<Geometry>::apply([](auto & g)
+        {
+            clear<std::remove_reference_t<decltype(g)>>::apply(g);
+        }, geometry);
+    }
+};
+
+template <typename Geometry>
+struct clear<Geometry, geometry_collection_tag>
+    : detail::clear::collection_clear<Geometry>
+{};
+
+}
+
+namespace dispatch
+{
+
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct visit_one
+{
+    template <typename F, typename G>
+    static void apply(F && f, G & g)
+    {
+        f(g);
+    }
+};
+
+template <typename Geometry>
+struct visit_one<Geometry, void>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry);
+};
 
 template <typename Geometry>
 struct visit_one<Geometry, dynamic_geometry_tag>
@@ -380,6 +1194,66 @@ inline void visit(UnaryFunction && function, Geometry1 & geometry1, Geometry2 &
 }
 
 
+namespace detail
+{
+
+// Calls the function passed into a traversal and returns false if the traversal
+// should be stopped. Only a function returning exactly bool can stop the traversal,
+// false meaning stop. The result of any other type, e.g. an int or a pointer which
+// happens to be convertible to bool, is ignored. Pairwise traversals pass two geometries.
+template
+<
+    typename F, typename ...Gs,
+    std::enable_if_t<! std::is_same<decltype(std::declval<F&>()(std::declval<Gs&>()...)), bool>::value, int> = 0
+>
+inline bool call_visit_function(F & f, Gs & ...gs)
+{
+    f(gs...);
+    return true;
+}
+
+template
+<
+    typename F, typename ...Gs,
+    std::enable_if_t<std::is_same<decltype(std::declval<F&>()(std::declval<Gs&>()...)), bool>::value, int> = 0
+>
+inline bool call_visit_function(F & f, Gs & ...gs)
+{
+    return f(gs...);
+}
+
+// Calls the visit function for StaticGeometries stored in the TupledGeometry in
+// the order of the tuple until it returns false
+template <std::size_t I, std::size_t N>
+struct tupled_visit
+{
+    template <typename Visit, typename TupledGeometry>
+    static bool apply(Visit & visit, TupledGeometry & tupled)
+    {
+        return visit(std::get<I>(tupled))
+            && tupled_visit<I + 1, N>::apply(visit, tupled);
+    }
+};
+
+template <std::size_t N>
+struct tupled_visit<N, N>
+{
+    template <typename Visit, typename TupledGeometry>
+    static bool apply(Visit & , TupledGeometry & )
+    {
+        return true;
+    }
+};
+
+template <typename Visit, typename TupledGeometry>
+inline bool visit_tupled(Visit & visit, TupledGeometry & tupled)
+{
+    using types_t = typename traits::geometry_types<util::remove_cref_t<TupledGeometry>>::type;
+    return tupled_visit<0, util::sequence_size<types_t>::value>::apply(visit, tupled);
+}
+
+} // namespace detail
+
 namespace dispatch
 {
 
@@ -387,9 +1261,9 @@ template <typename Geometry, typename Tag = typename tag<Geometry>::type>
 struct visit_breadth_first
 {
     template <typename F, typename G>
-    static void apply(F f, G & g)
+    static bool apply(F & f, G & g)
     {
-        f(g);
+        return detail::call_visit_function(f, g);
     }
 };
 
@@ -405,12 +1279,29 @@ template <typename Geometry>
 struct visit_breadth_first<Geometry, dynamic_geometry_tag>
 {
     template <typename Geom, typename F>
-    static void apply(F function, Geom & geom)
+    static bool apply(F & function, Geom & geom)
     {
+        bool result = true;
         traits::visit<util::remove_cref_t<Geom>>::apply([&](auto & g)
         {
-            visit_breadth_first<decltype(g)>::apply(function, g);
+            result = visit_breadth_first<decltype(g)>::apply(function, g);
         }, geom);
+        return result;
+    }
+};
+
+// StaticGeometries stored in TupledGeometry are visited in the order of the tuple
+template <typename Geometry>
+struct visit_breadth_first<Geometry, tupled_geometry_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        auto visit = [&](auto & g)
+        {
+            return detail::call_visit_function(function, g);
+        };
+        return detail::visit_tupled(visit, geom);
     }
 };
 
@@ -418,59 +1309,66 @@ template <typename Geometry>
 struct visit_breadth_first<Geometry, geometry_collection_tag>
 {
     template <typename F, typename Geom>
-    static void apply(F function, Geom & geom)
+    static bool apply(F & function, Geom & geom)
     {
-        using iter_t = typename boost::range_iterator<Geom>::type;
-        std::deque<iter_t> queue;
+        // Pointers to nested GeometryCollections are stored so they don't have to
+        // be visited again when taken from the queue.
+        using nested_t = typename detail::nested_geometry_collection<util::remove_cref_t<Geom>>::type;
+        using gc_t = util::transcribe_const_t
+            <
+                Geom,
+                std::conditional_t<std::is_void<nested_t>::value, util::remove_cref_t<Geom>, nested_t>
+            >;
+        detail::small_queue<gc_t *, 16> queue;
 
-        iter_t it = boost::begin(geom);
-        iter_t end = boost::end(geom);
-        for(;;)
+        if (! visit_elements(function, geom, queue))
         {
-            for (; it != end; ++it)
-            {
-                traits::visit_iterator<util::remove_cref_t<Geom>>::apply([&](auto & g)
-                {
-                    visit_or_enqueue(function, g, queue, it);
-                }, it);
-            }
-
-            if (queue.empty())
+            return false;
+        }
+        while (! queue.empty())
+        {
+            gc_t * gc = queue.front();
+            queue.pop_front();
+            if (! visit_elements(function, *gc, queue))
             {
-                break;
+                return false;
             }
-        
-            // Alternatively store a pointer to GeometryCollection
-            // so this call can be avoided.
-            traits::visit_iterator<util::remove_cref_t<Geom>>::apply([&](auto & g)
-            {
-                set_iterators(g, it, end);
-            }, queue.front());
-            queue.pop_front();
         }
+        return true;
     }
 
 private:
-    template <typename F, typename Geom, typename Iterator, std::enable_if_t<util::is_geometry_collection<Geom>::value, int> = 0>
-    static void visit_or_enqueue(F &, Geom &, std::deque<Iterator> & queue, Iterator iter)
+    template <typename F, typename Geom, typename Queue>
+    static bool visit_elements(F & function, Geom & geom, Queue & queue)
     {
-        queue.push_back(iter);
+        using iter_t = typename boost::range_iterator<Geom>::type;
+        iter_t const end = boost::end(geom);
+        for (iter_t it = boost::begin(geom); it != end; ++it)
+        {
+            bool result = true;
+            traits::visit_iterator<util::remove_cref_t<Geom>>::apply([&](auto & g)
+            {
+                result = visit_or_enqueue(function, g, queue);
+            }, it);
+            if (! result)
+            {
+                return false;
+            }
+        }
+        return true;
     }
-    template <typename F, typename Geom, typename Iterator, std::enable_if_t<! util::is_geometry_collection<Geom>::value, int> = 0>
-    static void visit_or_enqueue(F & f, Geom & g, std::deque<Iterator> & , Iterator)
+
+    template <typename F, typename Geom, typename Queue, std::enable_if_t<util::is_geometry_collection<Geom>::value, int> = 0>
+    static bool visit_or_enqueue(F &, Geom & g, Queue & queue)
     {
-        f(g);
+        queue.push_back(boost::addressof(g));
+        return true;
     }
-
-    template <typename Geom, typename Iterator, std::enable_if_t<util::is_geometry_collection<Geom>::value, int> = 0>
-    static void set_iterators(Geom & g, Iterator & first, Iterator & last)
+    template <typename F, typename Geom, typename Queue, std::enable_if_t<! util::is_geometry_collection<Geom>::value, int> = 0>
+    static bool visit_or_enqueue(F & f, Geom & g, Queue & )
     {
-        first = boost::begin(g);
-        last = boost::end(g);
+        return detail::call_visit_function(f, g);
     }
-    template <typename Geom, typename Iterator, std::enable_if_t<!util::is_geometry_collection<Geom>::value, int> = 0>
-    static void set_iterators(Geom &, Iterator &, Iterator &)
-    {}
 };
 
 } // namespace dispatch
@@ -485,10 +1383,429 @@ private:
 //   TODO: Or should this work only for GeometryCollection?
 // NOTE: The number of elements visited may be different than the size of the
 //   top-most GeometryCollection.
+// NOTE: The traversal is stopped if the function returns false. In this case
+//   false is returned, otherwise true.
+// NOTE: The function is passed by reference through all levels and adapters so
+//   it's never copied and its state is kept, the same in other traversals.
+template <typename UnaryFunction, typename Geometry>
+inline bool visit_breadth_first(UnaryFunction && function, Geometry & geometry)
+{
+    return dispatch::visit_breadth_first<Geometry>::apply(function, geometry);
+}
+
+
+namespace detail
+{
+
+// Orders of visit_depth_first
+struct depth_first_leaves {};
+struct depth_first_pre_order {};
+struct depth_first_post_order {};
+
+} // namespace detail
+
+namespace dispatch
+{
+
+template
+<
+    typename Geometry,
+    typename Order,
+    typename Tag = typename tag<Geometry>::type
+>
+struct visit_depth_first
+{
+    template <typename F, typename G>
+    static bool apply(F & f, G & g)
+    {
+        return detail::call_visit_function(f, g);
+    }
+};
+
+template <typename Geometry, typename Order>
+struct visit_depth_first<Geometry, Order, void>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry);
+};
+
+template <typename Geometry, typename Order>
+struct visit_depth_first<Geometry, Order, dynamic_geometry_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        bool result = true;
+        traits::visit<util::remove_cref_t<Geom>>::apply([&](auto & g)
+        {
+            result = visit_depth_first<decltype(g), Order>::apply(function, g);
+        }, geom);
+        return result;
+    }
+};
+
+// NOTE: TupledGeometry is not a GeometryCollection so the function is called only
+//   for StaticGeometries in all orders.
+template <typename Geometry, typename Order>
+struct visit_depth_first<Geometry, Order, tupled_geometry_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        auto visit = [&](auto & g)
+        {
+            return detail::call_visit_function(function, g);
+        };
+        return detail::visit_tupled(visit, geom);
+    }
+};
+
+template <typename Geometry, typename Order>
+struct visit_depth_first<Geometry, Order, geometry_collection_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        using nested_t = typename detail::nested_geometry_collection<util::remove_cref_t<Geom>>::type;
+        using gc_t = util::transcribe_const_t
+            <
+                Geom,
+                std::conditional_t<std::is_void<nested_t>::value, util::remove_cref_t<Geom>, nested_t>
+            >;
+        using iter_t = typename boost::range_iterator<gc_t>::type;
+
+        // Explicit stack of the nested GeometryCollections being traversed,
+        // the size is proportional to the depth, not to the number of elements.
+        struct frame
+        {
+            gc_t * gc;
+            iter_t it;
+            iter_t end;
+        };
+        detail::small_stack<frame, 16> stack;
+
+        if (! call(function, geom, Order(), detail::depth_first_pre_order()))
+        {
+            return false;
+        }
+
+        using root_iter_t = typename boost::range_iterator<Geom>::type;
+        root_iter_t const root_end = boost::end(geom);
+        for (root_iter_t root_it = boost::begin(geom); root_it != root_end; ++root_it)
+        {
+            bool result = true;
+            traits::visit_iterator<util::remove_cref_t<Geom>>::apply([&](auto & g)
+            {
+                result = visit_or_push(function, g, stack);
+            }, root_it);
+
+            while (result && ! stack.empty())
+            {
+                frame & top = stack.back();
+                if (top.it == top.end)
+                {
+                    gc_t & gc = *top.gc;
+                    stack.pop_back();
+                    result = call(function, gc, Order(), detail::depth_first_post_order());
+                    continue;
+                }
+
+                // The frame may be moved by push_back so increment first
+                iter_t const it = top.it++;
+                traits::visit_iterator<util::remove_cref_t<gc_t>>::apply([&](auto & g)
+                {
+                    result = visit_or_push(function, g, stack);
+                }, it);
+            }
+
+            if (! result)
+            {
+                return false;
+            }
+        }
+
+        return call(function, geom, Order(), detail::depth_first_post_order());
+    }
+
+private:
+    template <typename F, typename Geom, typename Stack, std::enable_if_t<util::is_geometry_collection<Geom>::value, int> = 0>
+    static bool visit_or_push(F & f, Geom & g, Stack & stack)
+    {
+        if (! call(f, g, Order(), detail::depth_first_pre_order()))
+        {
+            return false;
+        }
+        stack.push_back({ boost::addressof(g), boost::begin(g), boost::end(g) });
+        return true;
+    }
+    template <typename F, typename Geom, typename Stack, std::enable_if_t<! util::is_geometry_collection<Geom>::value, int> = 0>
+    static bool visit_or_push(F & f, Geom & g, Stack & )
+    {
+        return detail::call_visit_function(f, g);
+    }
+
+    // Calls the function for a GeometryCollection if the Order matches the moment
+    template <typename F, typename Geom, typename O>
+    static bool call(F & f, Geom & g, O, O)
+    {
+        return detail::call_visit_function(f, g);
+    }
+    template <typename F, typename Geom, typename O1, typename O2>
+    static bool call(F & , Geom & , O1, O2)
+    {
+        return true;
+    }
+};
+
+} // namespace dispatch
+
+// NOTE: Similar to visit_breadth_first but the elements are visited in the order
+//   in which they are stored. Nested GeometryCollections are traversed when they
+//   are encountered, so only the state for the current path is kept.
+//   The function is called only for StaticGeometries that are not GeometryCollections.
+// NOTE: The traversal is stopped if the function returns false. In this case
+//   false is returned, otherwise true.
 template <typename UnaryFunction, typename Geometry>
-inline void visit_breadth_first(UnaryFunction function, Geometry & geometry)
+inline bool visit_depth_first(UnaryFunction && function, Geometry & geometry)
 {
-    dispatch::visit_breadth_first<Geometry>::apply(function, geometry);
+    return dispatch::visit_depth_first
+        <
+            Geometry, detail::depth_first_leaves
+        >::apply(function, geometry);
+}
+
+// NOTE: The function is also called for GeometryCollections, including the
+//   top-most one, before their elements are visited.
+template <typename UnaryFunction, typename Geometry>
+inline bool visit_pre_order(UnaryFunction && function, Geometry & geometry)
+{
+    return dispatch::visit_depth_first
+        <
+            Geometry, detail::depth_first_pre_order
+        >::apply(function, geometry);
+}
+
+// NOTE: The function is also called for GeometryCollections, including the
+//   top-most one, after their elements are visited.
+template <typename UnaryFunction, typename Geometry>
+inline bool visit_post_order(UnaryFunction && function, Geometry & geometry)
+{
+    return dispatch::visit_depth_first
+        <
+            Geometry, detail::depth_first_post_order
+        >::apply(function, geometry);
+}
+
+
+namespace detail { namespace visit_grouped
+{
+
+// Pointers to StaticGeometries of each type of geometry_types
+// NOTE: The vectors of pointers are kept in a thread-local list after the call and
+//   reused by the next calls in the same thread so they're not allocated each time.
+//   Nested calls, e.g. from the function, take other vectors from the list.
+//   The memory is released when the thread exits.
+template
+<
+    typename Geometry,
+    typename TypeSequence = typename traits::geometry_types<util::remove_cref_t<Geometry>>::type
+>
+class groups;
+
+template <typename Geometry, typename ...Ts>
+class groups<Geometry, util::type_sequence<Ts...>>
+{
+    using types_t = util::type_sequence<Ts...>;
+    using pointers_t = std::tuple<std::vector<util::transcribe_const_t<Geometry, Ts> *>...>;
+
+public:
+    groups()
+    {
+        auto & list = free_list();
+        if (list.empty())
+        {
+            m_pointers.reset(new pointers_t());
+        }
+        else
+        {
+            m_pointers = std::move(list.back());
+            list.pop_back();
+        }
+    }
+
+    groups(groups const&) = delete;
+    groups & operator=(groups const&) = delete;
+
+    ~groups()
+    {
+        clear(std::index_sequence_for<Ts...>());
+        try
+        {
+            free_list().push_back(std::move(m_pointers));
+        }
+        catch (...)
+        {
+            // The vectors are released
+        }
+    }
+
+    template <typename G>
+    void add(G & g)
+    {
+        static const std::size_t I = sequence_index<util::remove_cref_t<G>, types_t>::value;
+        BOOST_GEOMETRY_STATIC_ASSERT(I < sizeof...(Ts),
+            "The Geometry is not in geometry_types.",
+            G);
+        std::get<I>(*m_pointers).push_back(boost::addressof(g));
+    }
+
+    template <typename F>
+    bool call(F & f)
+    {
+        return call<0>(f);
+    }
+
+private:
+    template <std::size_t I, typename F, std::enable_if_t<(I < sizeof...(Ts)), int> = 0>
+    bool call(F & f)
+    {
+        using geom_t = typename util::sequence_element<I, types_t>::type;
+        return call_group(f, std::get<I>(*m_pointers), util::is_geometry_collection<geom_t>())
+            && call<I + 1>(f);
+    }
+    template <std::size_t I, typename F, std::enable_if_t<(I >= sizeof...(Ts)), int> = 0>
+    bool call(F & )
+    {
+        return true;
+    }
+
+    template <typename F, typename Pointers>
+    static bool call_group(F & f, Pointers & pointers, std::false_type /*is_gc*/)
+    {
+        if (pointers.empty())
+        {
+            return true;
+        }
+        auto range = boost::adaptors::indirect(pointers);
+        return detail::call_visit_function(f, range);
+    }
+    template <typename F, typename Pointers>
+    static bool call_group(F & , Pointers & , std::true_type /*is_gc*/)
+    {
+        return true;
+    }
+
+    template <std::size_t ...Is>
+    void clear(std::index_sequence<Is...>)
+    {
+        int const dummy[] = { 0, (std::get<Is>(*m_pointers).clear(), 0)... };
+        boost::ignore_unused(dummy);
+    }
+
+    static std::vector<std::unique_ptr<pointers_t>> & free_list()
+    {
+        static thread_local std::vector<std::unique_ptr<pointers_t>> list;
+        return list;
+    }
+
+    std::unique_ptr<pointers_t> m_pointers;
+};
+
+}} // namespace detail::visit_grouped
+
+namespace dispatch
+{
+
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct visit_grouped
+{
+    template <typename F, typename G>
+    static bool apply(F & f, G & g)
+    {
+        auto range = boost::make_iterator_range(boost::addressof(g), boost::addressof(g) + 1);
+        return detail::call_visit_function(f, range);
+    }
+};
+
+template <typename Geometry>
+struct visit_grouped<Geometry, void>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry);
+};
+
+template <typename Geometry>
+struct visit_grouped_dynamic
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        BOOST_GEOMETRY_STATIC_ASSERT(
+            (! traits::visit_yields_temporaries<util::remove_cref_t<Geom>>::value),
+            "Groups can't point to temporary StaticGeometries created during traversal of this Geometry.",
+            Geom);
+
+        detail::visit_grouped::groups<Geom> groups;
+        geometry::visit_depth_first([&](auto & g)
+        {
+            groups.add(g);
+        }, geom);
+        return groups.call(function);
+    }
+};
+
+template <typename Geometry>
+struct visit_grouped<Geometry, dynamic_geometry_tag>
+    : visit_grouped_dynamic<Geometry>
+{};
+
+template <typename Geometry>
+struct visit_grouped<Geometry, geometry_collection_tag>
+    : visit_grouped_dynamic<Geometry>
+{};
+
+// StaticGeometries stored in TupledGeometry have different types so each of them
+// is passed as a range of one geometry
+template <typename Geometry>
+struct visit_grouped<Geometry, tupled_geometry_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        auto visit = [&](auto & g)
+        {
+            return visit_grouped<util::remove_cref_t<decltype(g)>>::apply(function, g);
+        };
+        return detail::visit_tupled(visit, geom);
+    }
+};
+
+} // namespace dispatch
+
+// NOTE: Calls the function once for each type of StaticGeometries stored in the
+//   Geometry, including the ones stored in nested GeometryCollections, with a range
+//   of all geometries of this type, e.g.:
+//     visit_grouped([](auto & range) {
+//         for (auto & g : range) ...
+//     }, gc);
+//   so dispatching is done once per type instead of once per element. The ranges are
+//   passed in the order of geometry_types and the function is not called for types not
+//   stored in the Geometry. In general the ranges are indirect: they iterate over
+//   pointers gathered in one traversal and dereference them, so the geometries are
+//   not contiguous in memory and the grouping saves dispatching, not memory accesses.
+//   Only collections storing each type contiguously, e.g. soa_geometry_collection,
+//   pass their containers directly.
+// NOTE: The traversal is stopped if the function returns false. In this case
+//   false is returned, otherwise true.
+template <typename UnaryFunction, typename Geometry>
+inline bool visit_grouped(UnaryFunction && function, Geometry & geometry)
+{
+    return dispatch::visit_grouped
+        <
+            util::remove_cref_t<Geometry>
+        >::apply(function, geometry);
 }
 
 
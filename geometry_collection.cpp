@@ -1,12 +1,28 @@
+#include "arena_allocator.hpp"
 #include "boost_any.hpp"
 #include "boost_variant.hpp"
 #include "boost_variant2.hpp"
+#include "cached_envelope_collection.hpp"
+#include "collection_pairwise.hpp"
+#include "collection_rtree.hpp"
+#include "distance.hpp"
+#include "envelope.hpp"
+#include "flat_geometry_collection.hpp"
 #include "geometry.hpp"
+#include "measure.hpp"
 #include "my_geometry.hpp"
 #include "my_geometry1.hpp"
 #include "my_geometry2.hpp"
+#include "predicates.hpp"
+#include "read_wkt.hpp"
+#include "soa_geometry_collection.hpp"
+#include "visit_parallel.hpp"
+#include "wkb.hpp"
+#include "wkb_view.hpp"
 
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 namespace bg = boost::geometry;
 
@@ -33,8 +49,18 @@ struct geometry_collection2 : std::vector<variant2>
     geometry_collection2(std::initializer_list<variant2> l) : std::vector<variant2>(l) {}
 };
 
+using arena_linestring = bg::model::linestring<point, std::vector, bg::model::arena_allocator>;
+using arena_polygon = bg::model::polygon<point, true, true, std::vector, std::vector, bg::model::arena_allocator, bg::model::arena_allocator>;
+struct arena_collection;
+using arena_variant = boost::variant<point, arena_linestring, arena_polygon, arena_collection>;
+struct arena_collection : bg::model::geometry_collection<arena_variant, std::vector, bg::model::arena_allocator>
+{
+    using bg::model::geometry_collection<arena_variant, std::vector, bg::model::arena_allocator>::geometry_collection;
+};
+
 BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(geometry_collection1, point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection1)
 BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(geometry_collection2, point, linestring, polygon, mpoint, mlinestring, mpolygon, geometry_collection2)
+BOOST_GEOMETRY_REGISTER_GEOMETRY_COLLECTION(arena_collection, point, arena_linestring, arena_polygon, arena_collection)
 BOOST_GEOMETRY_REGISTER_DYNAMIC_GEOMETRY(boost::any, point, linestring, polygon, mpoint, mlinestring, mpolygon, bg::model::geometry_collection<boost::any>)
 
 template <typename Geometry>
@@ -46,6 +72,165 @@ void print(Geometry & geometry)
     std::cout << std::endl;
 }
 
+template <typename Geometry>
+void print_depth_first(Geometry & geometry)
+{
+    bg::visit_depth_first([&](auto & g) {
+        std::cout << bg::wkt(g) << ' ';
+    }, geometry);
+    std::cout << std::endl;
+}
+
+struct print_tree
+{
+    template <typename Geometry, std::enable_if_t<bg::util::is_geometry_collection<Geometry>::value, int> = 0>
+    void operator()(Geometry & )
+    {
+        std::cout << "GC ";
+    }
+
+    template <typename Geometry, std::enable_if_t<! bg::util::is_geometry_collection<Geometry>::value, int> = 0>
+    void operator()(Geometry & g)
+    {
+        std::cout << bg::wkt(g) << ' ';
+    }
+};
+
+template <typename Geometry>
+void print_orders(Geometry & geometry)
+{
+    print(geometry);
+    print_depth_first(geometry);
+    bg::visit_pre_order(print_tree(), geometry);
+    std::cout << std::endl;
+    bg::visit_post_order(print_tree(), geometry);
+    std::cout << std::endl;
+}
+
+struct count_visitor
+{
+    template <typename Geometry>
+    void operator()(Geometry const& )
+    {
+        ++count;
+    }
+
+    template <typename Geometry1, typename Geometry2>
+    void operator()(Geometry1 const& , Geometry2 const& )
+    {
+        ++count;
+    }
+
+    std::size_t count = 0;
+};
+
+// Throws when the point with the given x coordinate is visited
+struct throwing_visitor
+{
+    void operator()(point const& p)
+    {
+        if (bg::get<0>(p) == x)
+        {
+            throw std::runtime_error("visit_parallel");
+        }
+    }
+
+    template <typename Geometry>
+    void operator()(Geometry const& )
+    {}
+
+    double x;
+};
+
+// Counts its copies, traversals should pass the function by reference
+struct copy_counter
+{
+    copy_counter() = default;
+    copy_counter(copy_counter const& other)
+        : count(other.count)
+    {
+        ++copies;
+    }
+    copy_counter & operator=(copy_counter const& ) = default;
+
+    template <typename Geometry>
+    void operator()(Geometry const& )
+    {
+        ++count;
+    }
+
+    template <typename Geometry1, typename Geometry2>
+    void operator()(Geometry1 const& , Geometry2 const& )
+    {
+        ++count;
+    }
+
+    std::size_t count = 0;
+    static std::size_t copies;
+};
+
+std::size_t copy_counter::copies = 0;
+
+// Returns false if the function was copied
+template <typename Geometry>
+bool print_copies(Geometry & geometry)
+{
+    copy_counter counter;
+    std::size_t const copies = copy_counter::copies;
+    bg::visit(counter, geometry);
+    bg::visit(counter, geometry, geometry);
+    bg::visit_breadth_first(counter, geometry);
+    bg::visit_depth_first(counter, geometry);
+    bg::visit_pre_order(counter, geometry);
+    bg::visit_post_order(counter, geometry);
+    bg::visit_grouped(counter, geometry);
+    bg::visit_depth_first(copy_counter(), geometry);
+    std::cout << counter.count << ' ' << copy_counter::copies - copies << std::endl;
+    return copy_counter::copies == copies;
+}
+
+template <typename Geometry>
+void print_count_parallel(Geometry & geometry)
+{
+    std::size_t count = 0;
+    for (auto const& c : bg::visit_parallel(count_visitor(), geometry, 4).first)
+    {
+        count += c.count;
+    }
+    std::cout << count << std::endl;
+}
+
+template <typename Geometry1, typename Geometry2>
+void print_count_pairwise(Geometry1 & geometry1, Geometry2 & geometry2)
+{
+    for (bg::pairwise_pruning pruning : { bg::pairwise_pruning::none, bg::pairwise_pruning::sweep, bg::pairwise_pruning::rtree })
+    {
+        count_visitor visitor;
+        bg::visit_pairwise([&](auto const& g1, auto const& g2) { visitor(g1, g2); }, geometry1, geometry2, pruning);
+        std::size_t count = 0;
+        for (auto const& c : bg::visit_pairwise_parallel(count_visitor(), geometry1, geometry2, pruning, 4).first)
+        {
+            count += c.count;
+        }
+        std::cout << visitor.count << ' ' << count << ' ';
+    }
+    std::cout << std::endl;
+}
+
+template <typename Geometry>
+void print_grouped(Geometry & geometry)
+{
+    bg::visit_grouped([&](auto & range) {
+        std::cout << boost::size(range) << ':';
+        for (auto & g : range)
+        {
+            std::cout << ' ' << bg::wkt(g);
+        }
+        std::cout << "; ";
+    }, geometry);
+    std::cout << std::endl;
+}
+
 template <typename Geometry1, typename Geometry2>
 void test_visit(Geometry1 & geometry1, Geometry2 & geometry2)
 {
@@ -60,6 +245,13 @@ void test_visit(Geometry1 & geometry1, Geometry2 & geometry2)
     }, geometry1, geometry2);
 }
 
+template <typename Geometry>
+void print_measures(Geometry const& geometry)
+{
+    std::cout << bg::area(geometry) << ' ' << bg::length(geometry) << ' '
+              << bg::perimeter(geometry) << ' ' << bg::num_points(geometry) << std::endl;
+}
+
 template <typename Geometry, typename Element, std::enable_if_t<bg::util::is_geometry_collection<Geometry>::value, int> = 0>
 void emplace_back_if_gc(Geometry & geom, Element && el)
 {
@@ -109,6 +301,319 @@ int main()
     print(g5);
     print(cg5);
     
+    variant1 n1{ geometry_collection1{ point(1, 1), geometry_collection1{ point(2, 2), geometry_collection1{ point(3, 3) } }, point(4, 4), geometry_collection1{ point(5, 5) } } };
+    boost::any const n5{ bg::model::geometry_collection<boost::any>{ point(1, 1), bg::model::geometry_collection<boost::any>{ point(2, 2) }, point(3, 3) } };
+    MyGColl nmgc;
+    bg::range::emplace_back(nmgc, MyGColl{ MyPoint(), MyPoint() });
+    bg::range::emplace_back(nmgc, MyPoint());
+
+    print_orders(n1);
+    print_orders(n5);
+    print_orders(nmgc);
+
+    // Traversals are stopped when the function returns false
+    std::size_t visited = 0;
+    bool const completed_bf = bg::visit_breadth_first([&](auto & ) { return ++visited < 2; }, n1);
+    bool const completed_df = bg::visit_depth_first([&](auto & ) { return ++visited < 4; }, n5);
+    std::cout << visited << ' ' << completed_bf << ' ' << completed_df << std::endl;
+
+    print_count_parallel(n1);
+    print_count_parallel(n5);
+    print_count_parallel(nmgc);
+    print_count_parallel(cg3);
+    std::cout << bg::visit_parallel([](auto const& ) { return true; }, n5, 4).second << ' '
+              << bg::visit_parallel([](auto const& ) { return false; }, n5, 4).second << std::endl;
+
+    // Exceptions thrown by the function are rethrown after the traversal
+    bg::model::geometry_collection<boost::any> large;
+    bg::model::geometry_collection<boost::any> large_nested;
+    for (std::size_t i = 0; i < 5000; ++i)
+    {
+        bg::range::push_back(large, boost::any(point(i, i)));
+        bg::range::push_back(large_nested, boost::any(point(i, i)));
+    }
+    bg::range::push_back(large, boost::any(std::move(large_nested)));
+    try
+    {
+        bg::visit_parallel(throwing_visitor{ 4321 }, large, 4);
+    }
+    catch (std::runtime_error const& e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+
+    bg::model::soa_geometry_collection<point, linestring, polygon> soa;
+    bg::range::emplace_back(soa, linestring{ point(0, 0), point(1, 1) });
+    bg::range::emplace_back(soa, point(2, 2));
+    bg::range::emplace_back(soa, polygon{ { point(0, 0), point(0, 1), point(1, 1), point(0, 0) } });
+    bg::range::emplace_back(soa, point(3, 3));
+    bg::model::soa_geometry_collection<point, linestring, polygon> const& csoa = soa;
+    print(soa);
+    print_depth_first(csoa);
+    print_count_parallel(csoa);
+    print_grouped(csoa);
+    print_grouped(n1);
+    print_grouped(n5);
+    print_grouped(cg3);
+    std::cout << boost::size(soa) << ' ' << soa.geometries<point>().size() << std::endl;
+    bg::clear(soa);
+    print(soa);
+
+    // Nested collections compiled into contiguous containers
+    bg::model::flat_geometry_collection<point> const flat1(n1);
+    bg::model::flat_geometry_collection<point> flat5(n5);
+    bg::model::flat_geometry_collection<point> flat4(cg4);
+    bg::model::geometry_collection<variant> const multi{
+        polygon{ { point(0, 0), point(0, 3), point(3, 3), point(3, 0), point(0, 0) },
+                 { point(1, 1), point(2, 1), point(2, 2), point(1, 2), point(1, 1) } },
+        mpoint{ point(1, 1), point(2, 2) },
+        mlinestring{ { point(0, 0), point(1, 1) }, { point(2, 2), point(3, 3) } },
+        mpolygon{ polygon{ { point(0, 0), point(0, 1), point(1, 1), point(0, 0) } } } };
+    bg::model::flat_geometry_collection<point> const flat_multi(multi);
+    bg::model::flat_geometry_collection<point> const flat_copy(flat_multi);
+    print_orders(flat1);
+    print_orders(flat5);
+    print(flat4);
+    print(flat_copy);
+    print_count_parallel(flat1);
+    bg::visit_depth_first([](auto const& g) { std::cout << bg::area(g) << ' '; }, flat_multi);
+    std::cout << std::endl;
+    std::cout << flat1.num_nodes() << ' ' << flat1.num_points() << ' ' << flat_multi.num_points() << std::endl;
+
+    // Envelopes of nested collections
+    using box = bg::model::box<point>;
+    box b = bg::return_envelope<box>(n1);
+    std::cout << bg::wkt(b) << ' ' << bg::wkt(bg::return_envelope<box>(n5)) << ' '
+              << bg::wkt(bg::return_envelope<box>(flat_multi)) << std::endl;
+    bg::expand(b, multi);
+    std::cout << bg::wkt(b) << ' ' << bg::is_empty(n1) << ' ' << bg::is_empty(gc) << std::endl;
+
+    bg::model::cached_envelope_collection<geometry_collection1, box> cached{ geometry_collection1{ point(1, 1), geometry_collection1{ point(2, 2) } } };
+    std::cout << bg::wkt(bg::return_envelope<box>(cached)) << ' ';
+    bg::range::emplace_back(cached, linestring{ point(0, 5), point(5, 0) });
+    std::cout << bg::wkt(cached.envelope()) << ' ';
+    bg::clear(cached);
+    bg::range::emplace_back(cached, point(3, 3));
+    std::cout << bg::wkt(cached.envelope()) << std::endl;
+    print_depth_first(cached);
+
+    // Elements of nested collections found by envelopes
+    bg::index::collection_rtree<variant1 const> const rtree1(n1);
+    bg::index::collection_rtree<bg::model::flat_geometry_collection<point> const> const rtree_flat(flat_multi);
+    rtree1.query(bg::index::intersects(box(point(1.5, 1.5), point(3.5, 4.5))), [](auto const& g) {
+        std::cout << bg::wkt(g) << ' ';
+    });
+    rtree1.query(bg::index::nearest(point(5, 6), 1), [](auto const& g) {
+        std::cout << bg::wkt(g) << ' ';
+    });
+    rtree_flat.query(bg::index::within(box(point(0, 0), point(1.5, 1.5))), [](auto const& g) {
+        std::cout << bg::wkt(g) << ' ';
+    });
+    std::cout << rtree1.size() << ' ' << rtree_flat.size() << std::endl;
+
+    // Pairs of elements of two nested collections with intersecting envelopes
+    print_count_pairwise(n1, multi);
+    print_count_pairwise(flat_multi, n5);
+    bg::visit_pairwise([](auto const& g1, auto const& g2) {
+        std::cout << bg::wkt(g1) << ' ' << bg::wkt(g2) << ' ' << bg::intersects(g1, g2) << "; ";
+        return ! bg::intersects(g1, g2);
+    }, n1, multi);
+    std::cout << std::endl;
+
+    // Collections read from WKT, elements are stored as they are read
+    std::string const wkt = "GEOMETRYCOLLECTION(POINT(1 1), LINESTRING(0 0,1 1), GEOMETRYCOLLECTION(POINT(2 2), POLYGON((0 0,0 1,1 1,0 0))), POINT EMPTY)";
+    geometry_collection1 rgc1;
+    bg::read_wkt(wkt, rgc1);
+    print_orders(rgc1);
+    variant1 rv1;
+    bg::read_wkt("GEOMETRYCOLLECTION(MULTIPOINT((1 1),(2 2)), GEOMETRYCOLLECTION EMPTY)", rv1);
+    print_orders(rv1);
+    std::istringstream wkt_stream("geometrycollection(point(3 3), linestring(0 0,2 2))\n"
+                                  "GEOMETRYCOLLECTION(GEOMETRYCOLLECTION(POINT(4 4)))");
+    boost::any rany;
+    MyGColl rmgc;
+    bg::read_wkt(wkt_stream, rany);
+    bg::read_wkt(wkt_stream, rmgc);
+    print_orders(rany);
+    print_orders(rmgc);
+    try
+    {
+        geometry_collection1 invalid;
+        bg::read_wkt("GEOMETRYCOLLECTION(POINT(1 1), CIRCLE(0 0, 1))", invalid);
+    }
+    catch (bg::read_wkt_exception const& e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+
+    // Collections written and read as WKB
+    geometry_collection1 const wkb_gc{ point(1, 1), linestring{ point(0, 0), point(1, 1) },
+                                       geometry_collection1{ point(2, 2), linestring{ point(2, 2), point(3, 3) } } };
+    std::vector<std::uint8_t> wkb;
+    bg::write_wkb(wkb_gc, wkb);
+    std::size_t const wkb_size = wkb.size();
+    bg::write_ewkb(n1, 4326, wkb);
+    bg::write_wkb(multi, wkb);
+    geometry_collection1 wgc1;
+    variant1 wv1;
+    MyGColl wmgc;
+    std::uint8_t const* wkb_it = bg::read_wkb(wkb.data(), wkb.data() + wkb.size(), wgc1);
+    wkb_it = bg::read_wkb(wkb_it, wkb.data() + wkb.size(), wv1);
+    bg::read_wkb(wkb.data(), wkb.data() + wkb_size, wmgc);
+    print_orders(wgc1);
+    print_orders(wv1);
+    print_orders(wmgc);
+    bg::read_wkb(wkb_it, wkb.data() + wkb.size(), rany);
+    print(rany);
+    std::cout << wkb_size << ' ' << wkb.size() << std::endl;
+    try
+    {
+        bg::read_wkb(wkb.data(), wkb.data() + wkb_size - 1, wgc1);
+    }
+    catch (bg::read_wkb_exception const& e)
+    {
+        std::cout << e.what() << std::endl;
+    }
+
+    // Geometries viewed in WKB without copying
+    bg::model::wkb_view<point> const view1(wkb.data(), wkb.data() + wkb.size());
+    bg::model::wkb_view<point> const view2(view1.last(), wkb.data() + wkb.size());
+    bg::model::wkb_view<point> const view3(view2.last(), wkb.data() + wkb.size());
+    print_orders(view1);
+    print_orders(view2);
+    std::cout << bg::wkt(bg::return_envelope<box>(view2)) << ' '
+              << bg::wkt(bg::return_envelope<box>(view3)) << std::endl;
+    bg::visit_depth_first([](auto const& g) {
+        std::cout << bg::wkt(g) << ' ' << bg::area(g) << ' ' << bg::length(g) << ' ' << bg::num_points(g) << "; ";
+    }, view3);
+    std::cout << std::endl;
+    // Copies of views of GeometryCollections iterated after the view is copied
+    bg::model::wkb_view<point> const view1_copy = view1;
+    view1_copy.visit([](auto const g) { std::cout << bg::num_points(g) << ' '; });
+    std::cout << bg::num_points(view1) << std::endl;
+
+    // Areas, lengths, perimeters and numbers of points of all StaticGeometries
+    print_measures(multi);
+    print_measures(n1);
+    print_measures(n5);
+    print_measures(cg3);
+    print_measures(flat_multi);
+    print_measures(view3);
+    std::cout << bg::area_parallel(multi, 2) << ' ' << bg::length_parallel(multi, 2) << ' '
+              << bg::perimeter_parallel(n1, 2) << ' ' << bg::num_points_parallel(n5, false, 2) << std::endl;
+
+    // Distances of nearest StaticGeometries found in the order of distances of envelopes
+    point const p(4, 1);
+    variant2 const dv2{ geometry_collection2{ point(5, 5), linestring{ point(4, 0), point(4, 3) } } };
+    MyGeometry1 dmg1{ MyPoint1() };
+    MyGeometry2 dmg2{ MyPoint2() };
+    bg::read_wkt("GEOMETRYCOLLECTION(POINT(6 6),LINESTRING(7 0,7 1))", dmg1);
+    bg::read_wkt("GEOMETRYCOLLECTION(POINT(9 9),GEOMETRYCOLLECTION(LINESTRING(9 0,9 1)))", dmg2);
+    std::cout << bg::distance(p, multi) << ' ' << bg::distance(n1, p) << ' '
+              << bg::comparable_distance(p, n5) << ' ' << bg::distance(multi, n1) << ' '
+              << bg::distance(dv2, n5) << ' ' << bg::distance(rmgc, p) << ' '
+              << bg::distance(dmg1, dmg2) << ' ' << bg::comparable_distance(dmg2, dv2) << std::endl;
+    std::cout << bg::index::distance(p, rtree1) << ' ' << bg::index::comparable_distance(multi, rtree1) << std::endl;
+
+    // Predicates stopped at the first StaticGeometry deciding the result
+    std::cout << bg::intersects(point(0.5, 2), multi) << ' ' << bg::disjoint(n1, p) << ' '
+              << bg::intersects(n5, point(3, 3)) << ' ' << bg::intersects(multi, n1) << ' '
+              << bg::disjoint(dmg1, dmg2) << ' ' << bg::intersects(dv2, n5) << ' '
+              << bg::covered_by(p, dv2) << ' ' << bg::covered_by(n1, multi) << ' '
+              << bg::covered_by(n5, multi) << ' ' << bg::covered_by(mpoint{ point(4, 0), point(5, 5) }, dv2) << ' '
+              << bg::covered_by(linestring{ point(4, 1), point(4, 2) }, dv2) << ' '
+              << bg::covered_by(rmgc, bg::model::box<point>(point(0, 0), point(3, 3))) << ' '
+              << bg::covered_by(rgc1, multi) << ' ' << bg::covered_by(dmg2, dmg2) << std::endl;
+
+    // Geometries covered by a union of StaticGeometries touching each other
+    geometry_collection1 const adjacent{ linestring{ point(0, 0), point(1, 0) }, linestring{ point(1, 0), point(2, 0) },
+                                         polygon{ { point(0, 1), point(0, 2), point(1, 2), point(1, 1), point(0, 1) } },
+                                         polygon{ { point(1, 1), point(1, 2), point(2, 2), point(2, 1), point(1, 1) } } };
+    std::cout << bg::covered_by(linestring{ point(0, 0), point(2, 0) }, adjacent) << ' '
+              << bg::covered_by(linestring{ point(0, 1.5), point(2, 1.5) }, adjacent) << ' '
+              << bg::covered_by(bg::model::box<point>(point(0.5, 1), point(1.5, 2)), adjacent) << ' '
+              << bg::covered_by(linestring{ point(0, 0), point(3, 0) }, adjacent) << ' '
+              << bg::covered_by(polygon{ { point(0, 1), point(0, 3), point(2, 3), point(2, 1), point(0, 1) } }, adjacent)
+              << std::endl;
+
+    // Geometries appended at once, moved with move iterators
+    std::vector<linestring> alss{ linestring{ point(0, 0), point(1, 1) }, linestring{ point(2, 2), point(3, 3) } };
+    bg::model::geometry_collection<boost::any> agc;
+    bg::range::append(agc, std::make_move_iterator(alss.begin()), std::make_move_iterator(alss.end()));
+    bg::range::push_back(agc, boost::any(point(4, 4)));
+    MyPoint amp;
+    amp.x = 5;
+    amp.y = 5;
+    std::vector<MyLinestring> amlss(2);
+    amlss[0].push_back(amp);
+    amlss[1].push_back(amp);
+    MyGColl amgc;
+    bg::range::emplace_back(amgc, amp);
+    bg::range::append(amgc, std::make_move_iterator(amlss.begin()), std::make_move_iterator(amlss.end()));
+    bg::range::push_back(amgc, std::unique_ptr<MyGeometry>(new MyPoint(amp)));
+    std::vector<std::unique_ptr<MyLinestring>> amplss;
+    amplss.emplace_back(new MyLinestring);
+    amplss.back()->push_back(amp);
+    bg::range::append(amgc, std::make_move_iterator(amplss.begin()), std::make_move_iterator(amplss.end()));
+    bg::range::emplace_back(amgc, std::unique_ptr<MyPoint>(new MyPoint(amp)));
+    print_depth_first(agc);
+    print_depth_first(amgc);
+    std::cout << alss.front().size() << ' ' << amlss.front().size() << std::endl;
+
+    // StaticGeometries stored in a tuple traversed without dispatching and moved
+    // into GeometryCollections
+    using tupled_t = bg::model::tupled_geometry<mpoint, linestring, polygon>;
+    tupled_t tg{ mpoint{ point(0, 0), point(1, 1) },
+                 linestring{ point(2, 2), point(3, 3) },
+                 polygon{ { point(0, 0), point(0, 1), point(1, 1), point(0, 0) } } };
+    tupled_t tg2 = tg;
+    print_depth_first(tg);
+    print_grouped(tg);
+    std::cout << bg::wkt(bg::return_envelope<bg::model::box<point>>(tg)) << std::endl;
+    geometry_collection1 tgc1;
+    bg::range::append(tgc1, std::move(tg));
+    bg::model::geometry_collection<boost::any> tagc(std::move(tg2));
+    print_depth_first(tgc1);
+    print_depth_first(tagc);
+    std::cout << std::get<linestring>(tg).size() << ' ' << std::get<2>(tg2).outer().size() << std::endl;
+
+    // Functions are passed by reference through all adapters
+    bg::range::emplace_back(soa, point(4, 4));
+    bg::range::emplace_back(soa, linestring{ point(4, 4), point(5, 5) });
+    bool not_copied = print_copies(g1);
+    not_copied &= print_copies(cg2);
+    not_copied &= print_copies(g3);
+    not_copied &= print_copies(g4);
+    not_copied &= print_copies(cg5);
+    not_copied &= print_copies(n5);
+    not_copied &= print_copies(flat_multi);
+    not_copied &= print_copies(view3);
+    not_copied &= print_copies(mgc);
+    not_copied &= print_copies(nmgc);
+    not_copied &= print_copies(soa);
+    not_copied &= print_copies(csoa);
+    not_copied &= print_copies(cached);
+    if (! not_copied)
+    {
+        std::cout << "Functions were copied" << std::endl;
+        return 1;
+    }
+
+    // All levels of nested geometries are allocated from the arena
+    bg::model::monotonic_arena arena;
+    {
+        bg::model::arena_scope scope(arena);
+        arena_collection agc{ point(1, 1), arena_linestring{ point(0, 0), point(1, 1) }, arena_collection{ point(2, 2) } };
+        print_depth_first(agc);
+        arena_linestring const& als = boost::get<arena_linestring>(agc[1]);
+        arena_collection const& anested = boost::get<arena_collection>(agc[2]);
+        std::cout << (agc.get_allocator().arena() == &arena) << ' '
+                  << (als.get_allocator().arena() == &arena) << ' '
+                  << (anested.get_allocator().arena() == &arena) << ' '
+                  << (arena.reserved() > 0) << std::endl;
+    }
+    arena.release();
+
     bg::clear(gc);
     bg::clear(g1);
     bg::clear(g2);
@@ -0,0 +1,311 @@
+#ifndef MEASURE_HPP
+#define MEASURE_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include <boost/geometry/algorithms/area.hpp>
+#include <boost/geometry/algorithms/length.hpp>
+#include <boost/geometry/algorithms/num_points.hpp>
+#include <boost/geometry/algorithms/perimeter.hpp>
+
+#include "geometry.hpp"
+#include "visit_parallel.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace collection_measure {
+
+// Sums the results of the policy for all StaticGeometries stored in the Geometry,
+// including the ones stored in nested GeometryCollections, in one traversal.
+template <typename Result, typename Geometry, typename Policy>
+inline Result sum(Geometry const& geometry, Policy const& policy, std::false_type /*grouped_storage*/)
+{
+    Result result = 0;
+    geometry::visit_depth_first([&](auto const& g)
+    {
+        result += Result(policy(g));
+    }, geometry);
+    return result;
+}
+
+// StaticGeometries of each type are stored contiguously so the policy is called in
+// a loop over geometries of one type instead of being dispatched for each element.
+template <typename Result, typename Geometry, typename Policy>
+inline Result sum(Geometry const& geometry, Policy const& policy, std::true_type /*grouped_storage*/)
+{
+    Result result = 0;
+    geometry::visit_grouped([&](auto const& range)
+    {
+        for (auto const& g : range)
+        {
+            result += Result(policy(g));
+        }
+    }, geometry);
+    return result;
+}
+
+template <typename Result, typename Geometry, typename Policy>
+inline Result sum(Geometry const& geometry, Policy const& policy)
+{
+    return sum<Result>(geometry, policy, traits::grouped_storage<Geometry>());
+}
+
+// Copied for each thread by visit_parallel
+template <typename Result, typename Policy>
+struct partial_sum
+{
+    template <typename G>
+    void operator()(G const& g)
+    {
+        result += Result(policy(g));
+    }
+
+    Policy policy;
+    Result result;
+};
+
+template <typename Result, typename Geometry, typename Policy>
+inline Result sum_parallel(Geometry const& geometry, Policy const& policy, std::size_t threads)
+{
+    Result result = 0;
+    for (auto const& s : geometry::visit_parallel(partial_sum<Result, Policy>{ policy, 0 },
+                                                  geometry, threads).first)
+    {
+        result += s.result;
+    }
+    return result;
+}
+
+template <typename Strategy>
+struct area_policy
+{
+    template <typename G>
+    auto operator()(G const& g) const
+    {
+        return dispatch::area<G>::apply(g, strategy);
+    }
+
+    Strategy const& strategy;
+};
+
+template <typename Strategy>
+struct length_policy
+{
+    template <typename G>
+    auto operator()(G const& g) const
+    {
+        return dispatch::length<G>::apply(g, strategy);
+    }
+
+    Strategy const& strategy;
+};
+
+template <typename Strategy>
+struct perimeter_policy
+{
+    template <typename G>
+    auto operator()(G const& g) const
+    {
+        return dispatch::perimeter<G>::apply(g, strategy);
+    }
+
+    Strategy const& strategy;
+};
+
+template <bool AddForOpen>
+struct num_points_policy
+{
+    template <typename G>
+    std::size_t operator()(G const& g) const
+    {
+        return dispatch::num_points<G, AddForOpen>::apply(g);
+    }
+};
+
+}} // namespace detail::collection_measure
+
+namespace dispatch
+{
+
+// NOTE: The strategies are passed to StaticGeometries so they have to support
+//   all geometry types stored in the Geometry. Results of StaticGeometries are
+//   converted to the result type of the Geometry.
+template <typename Geometry>
+struct area<Geometry, dynamic_geometry_tag>
+{
+    template <typename Strategy>
+    static inline typename area_result<Geometry, Strategy>::type
+        apply(Geometry const& geom, Strategy const& strategy)
+    {
+        typename area_result<Geometry, Strategy>::type result = 0;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = area<util::remove_cref_t<decltype(g)>>::apply(g, strategy);
+        }, geom);
+        return result;
+    }
+};
+
+template <typename Geometry>
+struct area<Geometry, geometry_collection_tag>
+{
+    template <typename Strategy>
+    static inline typename area_result<Geometry, Strategy>::type
+        apply(Geometry const& geom, Strategy const& strategy)
+    {
+        return detail::collection_measure::sum
+            <
+                typename area_result<Geometry, Strategy>::type
+            >(geom, detail::collection_measure::area_policy<Strategy>{ strategy });
+    }
+};
+
+template <typename Geometry>
+struct length<Geometry, dynamic_geometry_tag>
+{
+    using return_type = typename default_length_result<Geometry>::type;
+
+    template <typename Strategy>
+    static inline return_type apply(Geometry const& geom, Strategy const& strategy)
+    {
+        return_type result = 0;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = length<util::remove_cref_t<decltype(g)>>::apply(g, strategy);
+        }, geom);
+        return result;
+    }
+};
+
+template <typename Geometry>
+struct length<Geometry, geometry_collection_tag>
+{
+    using return_type = typename default_length_result<Geometry>::type;
+
+    template <typename Strategy>
+    static inline return_type apply(Geometry const& geom, Strategy const& strategy)
+    {
+        return detail::collection_measure::sum<return_type>(geom,
+                    detail::collection_measure::length_policy<Strategy>{ strategy });
+    }
+};
+
+template <typename Geometry>
+struct perimeter<Geometry, dynamic_geometry_tag>
+{
+    using return_type = typename default_length_result<Geometry>::type;
+
+    template <typename Strategy>
+    static inline return_type apply(Geometry const& geom, Strategy const& strategy)
+    {
+        return_type result = 0;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = perimeter<util::remove_cref_t<decltype(g)>>::apply(g, strategy);
+        }, geom);
+        return result;
+    }
+};
+
+template <typename Geometry>
+struct perimeter<Geometry, geometry_collection_tag>
+{
+    using return_type = typename default_length_result<Geometry>::type;
+
+    template <typename Strategy>
+    static inline return_type apply(Geometry const& geom, Strategy const& strategy)
+    {
+        return detail::collection_measure::sum<return_type>(geom,
+                    detail::collection_measure::perimeter_policy<Strategy>{ strategy });
+    }
+};
+
+template <typename Geometry, bool AddForOpen>
+struct num_points<Geometry, AddForOpen, dynamic_geometry_tag>
+{
+    static inline std::size_t apply(Geometry const& geom)
+    {
+        std::size_t result = 0;
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            result = num_points<util::remove_cref_t<decltype(g)>, AddForOpen>::apply(g);
+        }, geom);
+        return result;
+    }
+};
+
+template <typename Geometry, bool AddForOpen>
+struct num_points<Geometry, AddForOpen, geometry_collection_tag>
+{
+    static inline std::size_t apply(Geometry const& geom)
+    {
+        return detail::collection_measure::sum<std::size_t>(geom,
+                    detail::collection_measure::num_points_policy<AddForOpen>());
+    }
+};
+
+} // namespace dispatch
+
+// Versions of area, length, perimeter and num_points traversing GeometryCollections
+// with visit_parallel, e.g. for big GeometryCollections:
+//     auto const a = area_parallel(gc);
+// NOTE: Partial sums are calculated by each thread so the results can slightly
+//   differ from the results of sequential algorithms for floating point types.
+// NOTE: If threads is 0 std::thread::hardware_concurrency() threads are used.
+template <typename Geometry>
+inline typename area_result<Geometry>::type
+area_parallel(Geometry const& geometry, std::size_t threads = 0)
+{
+    using strategy_t = typename strategy::area::services::default_strategy
+        <
+            typename cs_tag<Geometry>::type
+        >::type;
+    using result_t = typename area_result<Geometry>::type;
+    strategy_t strategy;
+    return detail::collection_measure::sum_parallel<result_t>(geometry,
+                detail::collection_measure::area_policy<strategy_t>{ strategy }, threads);
+}
+
+template <typename Geometry>
+inline typename default_length_result<Geometry>::type
+length_parallel(Geometry const& geometry, std::size_t threads = 0)
+{
+    using strategy_t = typename strategy::distance::services::default_strategy
+        <
+            point_tag, point_tag, typename point_type<Geometry>::type
+        >::type;
+    using result_t = typename default_length_result<Geometry>::type;
+    strategy_t strategy;
+    return detail::collection_measure::sum_parallel<result_t>(geometry,
+                detail::collection_measure::length_policy<strategy_t>{ strategy }, threads);
+}
+
+template <typename Geometry>
+inline typename default_length_result<Geometry>::type
+perimeter_parallel(Geometry const& geometry, std::size_t threads = 0)
+{
+    using strategy_t = typename strategy::distance::services::default_strategy
+        <
+            point_tag, point_tag, typename point_type<Geometry>::type
+        >::type;
+    using result_t = typename default_length_result<Geometry>::type;
+    strategy_t strategy;
+    return detail::collection_measure::sum_parallel<result_t>(geometry,
+                detail::collection_measure::perimeter_policy<strategy_t>{ strategy }, threads);
+}
+
+template <typename Geometry>
+inline std::size_t num_points_parallel(Geometry const& geometry, bool add_for_open = false,
+                                       std::size_t threads = 0)
+{
+    return add_for_open
+        ? detail::collection_measure::sum_parallel<std::size_t>(geometry,
+            detail::collection_measure::num_points_policy<true>(), threads)
+        : detail::collection_measure::sum_parallel<std::size_t>(geometry,
+            detail::collection_measure::num_points_policy<false>(), threads);
+}
+
+}} // namespace boost::geometry
+
+#endif // MEASURE_HPP
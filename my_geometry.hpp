@@ -7,6 +7,7 @@ enum MyGeometryId { MyPointId, MyLinestringId, MyGCollId };
 
 struct MyGeometry
 {
+    virtual ~MyGeometry() = default;
     virtual MyGeometryId which() const = 0;
 };
 struct MyPoint : MyGeometry
@@ -43,37 +44,54 @@ struct tag<MyGColl>
     typedef geometry_collection_tag type;
 };
 
+template <>
+struct geometry_types<MyGColl>
+{
+    typedef util::type_sequence<MyPoint, MyLinestring, MyGColl> type;
+};
+
+// NOTE: MyGeometryId is the index of the type in geometry_types
 template <>
 struct visit_iterator<MyGColl>
 {
     template <typename Function, typename Iterator>
-    static void apply(Function function, Iterator iterator)
+    static void apply(Function && function, Iterator iterator)
     {
         auto & ptr = *iterator;
         using unique_ptr_t = std::remove_reference_t<decltype(ptr)>;
 
-        if (ptr->which() == MyPointId)
-            function(static_cast<util::transcribe_const_t<unique_ptr_t, MyPoint>&>(*ptr));
-        else if (ptr->which() == MyLinestringId)
-            function(static_cast<util::transcribe_const_t<unique_ptr_t, MyLinestring>&>(*ptr));
-        else if (ptr->which() == MyGCollId)
-            function(static_cast<util::transcribe_const_t<unique_ptr_t, MyGColl>&>(*ptr));
+        geometry::detail::visit_table::visit_derived
+            <
+                geometry_types<MyGColl>::type
+            >::apply(function, ptr->which(),
+                     static_cast<util::transcribe_const_t<unique_ptr_t, MyGeometry>&>(*ptr));
     }
 };
 
-template <>
-struct geometry_types<MyGColl>
-{
-    typedef util::type_sequence<MyPoint, MyLinestring, MyGColl> type;
-};
-
+// NOTE: Geometries are moved into the new objects if they're passed as r-values,
+//   owning pointers to geometries derived from MyGeometry are moved into the range
 template <>
 struct emplace_back<MyGColl>
 {
-    template <typename Geometry>
+    template
+    <
+        typename Geometry,
+        std::enable_if_t<std::is_base_of<MyGeometry, Geometry>::value, int> = 0
+    >
+    static inline void apply(MyGColl& range, std::unique_ptr<Geometry>&& ptr)
+    {
+        range.emplace_back(std::move(ptr));
+    }
+
+    template
+    <
+        typename Geometry,
+        std::enable_if_t<std::is_base_of<MyGeometry, util::remove_cref_t<Geometry>>::value, int> = 0
+    >
     static inline void apply(MyGColl& range, Geometry&& geometry)
     {
-        range.emplace_back(std::unique_ptr<MyGeometry>(new Geometry(std::forward<Geometry>(geometry))));
+        using geometry_t = util::remove_cref_t<Geometry>;
+        range.emplace_back(std::unique_ptr<MyGeometry>(new geometry_t(std::forward<Geometry>(geometry))));
     }
 };
 
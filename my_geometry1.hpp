@@ -44,18 +44,25 @@ struct tag<MyGeometry1>
     typedef dynamic_geometry_tag type;
 };
 
+// NOTE: visit is not specialized, the default one uses which and unsafe_get.
+//   MyGeometry1Id is the index of the type in geometry_types.
 template <>
-struct visit<MyGeometry1>
+struct which<MyGeometry1>
 {
-    template <typename Function, typename Geometry>
-    static void apply(Function function, Geometry & geometry)
+    static std::size_t apply(MyGeometry1 const& geometry)
     {
-        if (geometry.ptr->which() == MyPoint1Id)
-            function(static_cast<util::transcribe_const_t<Geometry, MyPoint1>&>(*geometry.ptr));
-        else if (geometry.ptr->which() == MyLinestring1Id)
-            function(static_cast<util::transcribe_const_t<Geometry, MyLinestring1>&>(*geometry.ptr));
-        else if (geometry.ptr->which() == MyGColl1Id)
-            function(static_cast<util::transcribe_const_t<Geometry, MyGColl1>&>(*geometry.ptr));
+        return geometry.ptr->which();
+    }
+};
+
+template <>
+struct unsafe_get<MyGeometry1>
+{
+    template <std::size_t I, typename Geometry>
+    static auto & apply(Geometry & geometry)
+    {
+        using elem_t = typename util::sequence_element<I, typename geometry_types<std::remove_const_t<Geometry>>::type>::type;
+        return static_cast<util::transcribe_const_t<Geometry, elem_t>&>(*geometry.ptr);
     }
 };
 
@@ -53,30 +53,14 @@ struct MyGColl2 : MyGeometryBase2, std::vector<MyGeometry2>
     MyGColl2(std::initializer_list<MyGeometry2> l) : std::vector<MyGeometry2>(l) {}
 };
 
-template <typename UnaryFunction>
-struct MyVisitorBase2Impl : MyVisitorBase2
+// Index of the type in geometry_types<MyGeometry2>
+struct MyVisitorBase2Which : MyVisitorBase2const
 {
-    MyVisitorBase2Impl(UnaryFunction function)
-        : m_function(function) {}
-
-    void apply(MyPoint2 & g) { m_function(g); }
-    void apply(MyLinestring2 & g) { m_function(g); }
-    void apply(MyGColl2 & g) { m_function(g); }
-    
-    UnaryFunction m_function;
-};
-
-template <typename UnaryFunction>
-struct MyVisitorBase2Implconst : MyVisitorBase2const
-{
-    MyVisitorBase2Implconst(UnaryFunction function)
-        : m_function(function) {}
-
-    void apply(MyPoint2 const& g) { m_function(g); }
-    void apply(MyLinestring2 const& g) { m_function(g); }
-    void apply(MyGColl2 const& g) { m_function(g); }
+    void apply(MyPoint2 const&) { index = 0; }
+    void apply(MyLinestring2 const&) { index = 1; }
+    void apply(MyGColl2 const&) { index = 2; }
 
-    UnaryFunction m_function;
+    std::size_t index = 3;
 };
 
 BOOST_GEOMETRY_REGISTER_POINT_2D(MyPoint2, double, cs::cartesian, x, y)
@@ -91,27 +75,38 @@ struct tag<MyGeometry2>
 };
 
 template <>
-struct visit<MyGeometry2>
+struct geometry_types<MyGeometry2>
 {
-    template <typename Function, typename Geometry>
-    static void apply(Function function, Geometry & geometry)
-    {
-        MyVisitorBase2Impl<Function> visitor(function);
-        static_cast<MyGeometryBase2&>(*geometry.ptr).apply(visitor);
-    }
+    typedef util::type_sequence<MyPoint2, MyLinestring2, MyGColl2> type;
+};
 
-    template <typename Function, typename Geometry>
-    static void apply(Function function, Geometry const& geometry)
+// NOTE: visit is not specialized, the default one uses which and unsafe_get.
+//   The visitor is applied once for each type, then the index is taken from
+//   the cache, so elements are visited without double dispatch.
+template <>
+struct which<MyGeometry2>
+{
+    static std::size_t apply(MyGeometry2 const& geometry)
     {
-        MyVisitorBase2Implconst<Function> visitor(function);
-        static_cast<MyGeometryBase2 const&>(*geometry.ptr).apply(visitor);
+        MyGeometryBase2 const& base = *geometry.ptr;
+        return geometry::detail::visit_table::cached_type_index<MyGeometry2>::apply(base, [&]()
+        {
+            MyVisitorBase2Which visitor;
+            base.apply(visitor);
+            return visitor.index;
+        });
     }
 };
 
 template <>
-struct geometry_types<MyGeometry2>
+struct unsafe_get<MyGeometry2>
 {
-    typedef util::type_sequence<MyPoint2, MyLinestring2, MyGColl2> type;
+    template <std::size_t I, typename Geometry>
+    static auto & apply(Geometry & geometry)
+    {
+        using elem_t = typename util::sequence_element<I, typename geometry_types<std::remove_const_t<Geometry>>::type>::type;
+        return static_cast<util::transcribe_const_t<Geometry, elem_t>&>(*geometry.ptr);
+    }
 };
 
 template <>
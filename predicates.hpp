@@ -0,0 +1,606 @@
+#ifndef PREDICATES_HPP
+#define PREDICATES_HPP
+
+#include <utility>
+
+#include <boost/geometry/algorithms/convert.hpp>
+#include <boost/geometry/algorithms/covered_by.hpp>
+#include <boost/geometry/algorithms/difference.hpp>
+#include <boost/geometry/algorithms/disjoint.hpp>
+#include <boost/geometry/algorithms/expand.hpp>
+#include <boost/geometry/algorithms/intersects.hpp>
+#include <boost/geometry/algorithms/is_empty.hpp>
+
+#include "collection_pairwise.hpp"
+#include "envelope.hpp"
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace collection_predicates {
+
+template <typename Geometry>
+using box_type = model::box<typename point_type<Geometry>::type>;
+
+// Strategy of DynamicGeometries and GeometryCollections, StaticGeometries stored in
+// them are checked with their default strategies
+struct default_strategies {};
+
+// StaticGeometry disjoint with DynamicGeometry or GeometryCollection. StaticGeometries
+// stored in the second geometry are checked one by one and the traversal is stopped
+// at the first one intersecting the first geometry.
+template
+<
+    typename Geometry1, typename Geometry2,
+    typename Tag1 = typename tag<Geometry1>::type
+>
+struct disjoint
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        if (geometry::is_empty(geometry1))
+        {
+            return true;
+        }
+
+        box_type<Geometry2> const box1 = geometry::return_envelope<box_type<Geometry2>>(geometry1);
+        return geometry::visit_depth_first([&](auto const& g)
+        {
+            return geometry::is_empty(g)
+                || geometry::disjoint(box1, geometry::return_envelope<box_type<Geometry2>>(g))
+                || geometry::disjoint(geometry1, g);
+        }, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2>
+struct disjoint<Geometry1, Geometry2, dynamic_geometry_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        bool result = true;
+        traits::visit<Geometry1>::apply([&](auto const& g)
+        {
+            result = disjoint<util::remove_cref_t<decltype(g)>, Geometry2>::apply(g, geometry2);
+        }, geometry1);
+        return result;
+    }
+};
+
+// Pairs of StaticGeometries with intersecting envelopes are checked, see visit_pairwise
+template <typename Geometry1, typename Geometry2>
+struct disjoint<Geometry1, Geometry2, geometry_collection_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        return geometry::visit_pairwise([](auto const& g1, auto const& g2)
+        {
+            return geometry::disjoint(g1, g2);
+        }, geometry1, geometry2);
+    }
+};
+
+// StaticGeometry covered_by StaticGeometry, false if the second geometry has
+// lower topological dimension, e.g. a linestring is never covered by points
+template <typename Geometry1, typename Geometry2>
+inline bool covered_by_static(Geometry1 const& , Geometry2 const& , std::true_type /*lower*/)
+{
+    return false;
+}
+
+template <typename Geometry1, typename Geometry2>
+inline bool covered_by_static(Geometry1 const& geometry1, Geometry2 const& geometry2, std::false_type /*lower*/)
+{
+    return geometry::covered_by(geometry1, geometry2);
+}
+
+template <typename Geometry1, typename Geometry2>
+inline bool covered_by_static(Geometry1 const& geometry1, Geometry2 const& geometry2)
+{
+    return covered_by_static(geometry1, geometry2,
+        std::integral_constant
+            <
+                bool,
+                (topological_dimension<Geometry2>::value < topological_dimension<Geometry1>::value)
+            >());
+}
+
+// True if any StaticGeometry stored in the GeometryCollection covers the StaticGeometry.
+// The traversal is stopped at the first one.
+template <typename Geometry, typename GeometryCollection>
+inline bool covered_by_any(Geometry const& geometry, GeometryCollection const& collection)
+{
+    using box_t = box_type<GeometryCollection>;
+    box_t const box = geometry::return_envelope<box_t>(geometry);
+    return ! geometry::visit_depth_first([&](auto const& g)
+    {
+        return geometry::is_empty(g)
+            || ! geometry::covered_by(box, geometry::return_envelope<box_t>(g))
+            || ! covered_by_static(geometry, g);
+    }, collection);
+}
+
+// Linear or areal StaticGeometry remaining after subtracting StaticGeometries
+// covering parts of it
+template
+<
+    typename Geometry,
+    typename CastedTag = typename tag_cast<typename tag<Geometry>::type, linear_tag, areal_tag>::type
+>
+struct remainder_type
+{};
+
+template <typename Geometry>
+struct remainder_type<Geometry, linear_tag>
+{
+    typedef model::multi_linestring<model::linestring<typename point_type<Geometry>::type>> type;
+};
+
+template <typename Geometry>
+struct remainder_type<Geometry, areal_tag>
+{
+    typedef model::multi_polygon<model::polygon<typename point_type<Geometry>::type>> type;
+};
+
+// Model a StaticGeometry is converted to before it's passed into difference
+template <typename Point, typename Tag>
+struct operand_type
+{};
+
+template <typename Point>
+struct operand_type<Point, segment_tag>
+{
+    typedef model::linestring<Point> type;
+};
+
+template <typename Point>
+struct operand_type<Point, linestring_tag>
+{
+    typedef model::linestring<Point> type;
+};
+
+template <typename Point>
+struct operand_type<Point, multi_linestring_tag>
+{
+    typedef model::multi_linestring<model::linestring<Point>> type;
+};
+
+template <typename Point>
+struct operand_type<Point, box_tag>
+{
+    typedef model::polygon<Point> type;
+};
+
+template <typename Point>
+struct operand_type<Point, ring_tag>
+{
+    typedef model::polygon<Point> type;
+};
+
+template <typename Point>
+struct operand_type<Point, polygon_tag>
+{
+    typedef model::polygon<Point> type;
+};
+
+template <typename Point>
+struct operand_type<Point, multi_polygon_tag>
+{
+    typedef model::multi_polygon<model::polygon<Point>> type;
+};
+
+// Linestrings and polygons with the same point type are passed into difference
+// directly, other StaticGeometries are converted
+template <typename Point, typename Geometry>
+using is_direct_operand = std::integral_constant
+    <
+        bool,
+        std::is_same<typename point_type<Geometry>::type, Point>::value
+     && (std::is_same<typename tag<Geometry>::type, linestring_tag>::value
+      || std::is_same<typename tag<Geometry>::type, multi_linestring_tag>::value
+      || std::is_same<typename tag<Geometry>::type, polygon_tag>::value
+      || std::is_same<typename tag<Geometry>::type, multi_polygon_tag>::value)
+    >;
+
+template
+<
+    typename Point, typename Geometry,
+    std::enable_if_t<is_direct_operand<Point, Geometry>::value, int> = 0
+>
+inline Geometry const& difference_operand(Geometry const& geometry)
+{
+    return geometry;
+}
+
+template
+<
+    typename Point, typename Geometry,
+    std::enable_if_t<! is_direct_operand<Point, Geometry>::value, int> = 0
+>
+inline typename operand_type<Point, typename tag<Geometry>::type>::type
+difference_operand(Geometry const& geometry)
+{
+    typename operand_type<Point, typename tag<Geometry>::type>::type result;
+    geometry::convert(geometry, result);
+    return result;
+}
+
+// Envelope of the remainder combined from envelopes of its parts
+template <typename Box, typename Remainder>
+inline Box remainder_envelope(Remainder const& remainder)
+{
+    Box box;
+    geometry::assign_inverse(box);
+    for (auto const& part : remainder)
+    {
+        geometry::expand(box, geometry::return_envelope<Box>(part));
+    }
+    return box;
+}
+
+// Subtracts the StaticGeometry from the remainder and returns true if nothing remains.
+// StaticGeometries with lower topological dimension can't cover any part.
+template <typename Remainder, typename Box, typename Geometry>
+inline bool subtract(Remainder & , Box & , Geometry const& , std::true_type /*lower*/)
+{
+    return false;
+}
+
+template <typename Remainder, typename Box, typename Geometry>
+inline bool subtract(Remainder & remainder, Box & box, Geometry const& geometry, std::false_type /*lower*/)
+{
+    if (geometry::disjoint(box, geometry::return_envelope<Box>(geometry)))
+    {
+        return false;
+    }
+
+    Remainder result;
+    geometry::difference(remainder, difference_operand<typename point_type<Remainder>::type>(geometry), result);
+    remainder = std::move(result);
+    if (geometry::is_empty(remainder))
+    {
+        return true;
+    }
+    box = remainder_envelope<Box>(remainder);
+    return false;
+}
+
+// True if the linear or areal StaticGeometry is covered by the union of StaticGeometries
+// stored in the GeometryCollection. StaticGeometries whose envelopes intersect the
+// envelope of the part remaining uncovered are subtracted from it one by one and the
+// traversal is stopped when nothing remains.
+template <typename Geometry, typename GeometryCollection>
+inline bool covered_by_union(Geometry const& geometry, GeometryCollection const& collection)
+{
+    using remainder_t = typename remainder_type<Geometry>::type;
+    using box_t = box_type<Geometry>;
+
+    remainder_t remainder;
+    geometry::convert(geometry, remainder);
+    if (geometry::is_empty(remainder))
+    {
+        return false;
+    }
+
+    box_t box = remainder_envelope<box_t>(remainder);
+    return ! geometry::visit_depth_first([&](auto const& g)
+    {
+        using geometry_t = util::remove_cref_t<decltype(g)>;
+        using lower_t = std::integral_constant
+            <
+                bool,
+                (topological_dimension<geometry_t>::value < topological_dimension<Geometry>::value)
+            >;
+        return geometry::is_empty(g)
+            || ! subtract(remainder, box, g, lower_t());
+    }, collection);
+}
+
+template
+<
+    typename Geometry, typename GeometryCollection,
+    typename CastedTag = typename tag_cast<typename tag<Geometry>::type, pointlike_tag>::type
+>
+struct covered_by_collection
+{
+    static inline bool apply(Geometry const& geometry, GeometryCollection const& collection)
+    {
+        return covered_by_union(geometry, collection);
+    }
+};
+
+// A Point is covered by the union only if it's covered by one of StaticGeometries
+template <typename Geometry, typename GeometryCollection>
+struct covered_by_collection<Geometry, GeometryCollection, pointlike_tag>
+{
+    static inline bool apply(Geometry const& geometry, GeometryCollection const& collection)
+    {
+        return covered_by_any(geometry, collection);
+    }
+};
+
+// StaticGeometry covered_by StaticGeometry, DynamicGeometry or GeometryCollection
+template
+<
+    typename Geometry1, typename Geometry2,
+    typename Tag1 = typename tag<Geometry1>::type,
+    typename Tag2 = typename tag<Geometry2>::type
+>
+struct covered_by_one
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        return covered_by_static(geometry1, geometry2);
+    }
+};
+
+// A StaticGeometry is covered by a box if its envelope is
+template <typename Geometry1, typename Geometry2, typename Tag1>
+struct covered_by_one<Geometry1, Geometry2, Tag1, box_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        return geometry::covered_by(geometry::return_envelope<box_type<Geometry1>>(geometry1), geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1>
+struct covered_by_one<Geometry1, Geometry2, Tag1, dynamic_geometry_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        bool result = false;
+        traits::visit<Geometry2>::apply([&](auto const& g)
+        {
+            result = covered_by_one<Geometry1, util::remove_cref_t<decltype(g)>>::apply(geometry1, g);
+        }, geometry2);
+        return result;
+    }
+};
+
+// The StaticGeometry may be covered by a union of several StaticGeometries stored
+// in the GeometryCollection, e.g. a linestring by two linestrings touching each other
+template <typename Geometry1, typename Geometry2, typename Tag1>
+struct covered_by_one<Geometry1, Geometry2, Tag1, geometry_collection_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        return covered_by_collection<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+// Every Point has to be covered by one of StaticGeometries
+template <typename Geometry1, typename Geometry2>
+struct covered_by_one<Geometry1, Geometry2, multi_point_tag, geometry_collection_tag>
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        for (auto const& p : geometry1)
+        {
+            if (! covered_by_any(p, geometry2))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// DynamicGeometry or GeometryCollection covered_by any Geometry. All non-empty
+// StaticGeometries stored in the first geometry have to be covered so the traversal
+// is stopped at the first one which is not.
+template <typename Geometry1, typename Geometry2>
+struct covered_by
+{
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2)
+    {
+        using box_t = box_type<Geometry1>;
+        box_t const box2 = geometry::return_envelope<box_t>(geometry2);
+        bool found = false;
+        bool const result = geometry::visit_depth_first([&](auto const& g)
+        {
+            if (geometry::is_empty(g))
+            {
+                return true;
+            }
+            found = true;
+            return geometry::covered_by(geometry::return_envelope<box_t>(g), box2)
+                && covered_by_one<util::remove_cref_t<decltype(g)>, Geometry2>::apply(g, geometry2);
+        }, geometry1);
+        return found && result;
+    }
+};
+
+}} // namespace detail::collection_predicates
+
+namespace strategy
+{
+
+// NOTE: Strategies are specific to pairs of geometry types so StaticGeometries
+//   stored in DynamicGeometries and GeometryCollections are checked with their
+//   default strategies. These are only defined so the algorithms can be called.
+//   geometry::default_strategy can't be used because the algorithms would select
+//   the default strategy again.
+namespace disjoint { namespace services
+{
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, int TopDim2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, -1, TopDim2, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, int TopDim1, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, TopDim1, -1, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, -1, -1, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+}} // namespace disjoint::services
+
+namespace covered_by { namespace services
+{
+
+template
+<
+    typename Geometry1, typename Geometry2, typename Tag1, typename Tag2,
+    typename CastedTag2, typename CsTag1, typename CsTag2
+>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, dynamic_geometry_tag, CastedTag2, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template
+<
+    typename Geometry1, typename Geometry2, typename Tag1, typename Tag2,
+    typename CastedTag2, typename CsTag1, typename CsTag2
+>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, geometry_collection_tag, CastedTag2, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template
+<
+    typename Geometry1, typename Geometry2, typename Tag1, typename Tag2,
+    typename CastedTag1, typename CsTag1, typename CsTag2
+>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, CastedTag1, dynamic_geometry_tag, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template
+<
+    typename Geometry1, typename Geometry2, typename Tag1, typename Tag2,
+    typename CastedTag1, typename CsTag1, typename CsTag2
+>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, CastedTag1, geometry_collection_tag, CsTag1, CsTag2>
+{
+    typedef geometry::detail::collection_predicates::default_strategies type;
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, dynamic_geometry_tag, dynamic_geometry_tag, CsTag1, CsTag2>
+    : default_strategy<Geometry1, Geometry2, Tag1, Tag2, dynamic_geometry_tag, void, CsTag1, CsTag2>
+{};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, dynamic_geometry_tag, geometry_collection_tag, CsTag1, CsTag2>
+    : default_strategy<Geometry1, Geometry2, Tag1, Tag2, dynamic_geometry_tag, void, CsTag1, CsTag2>
+{};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, geometry_collection_tag, dynamic_geometry_tag, CsTag1, CsTag2>
+    : default_strategy<Geometry1, Geometry2, Tag1, Tag2, geometry_collection_tag, void, CsTag1, CsTag2>
+{};
+
+template <typename Geometry1, typename Geometry2, typename Tag1, typename Tag2, typename CsTag1, typename CsTag2>
+struct default_strategy<Geometry1, Geometry2, Tag1, Tag2, geometry_collection_tag, geometry_collection_tag, CsTag1, CsTag2>
+    : default_strategy<Geometry1, Geometry2, Tag1, Tag2, geometry_collection_tag, void, CsTag1, CsTag2>
+{};
+
+}} // namespace covered_by::services
+
+} // namespace strategy
+
+namespace dispatch
+{
+
+// NOTE: DynamicGeometries and GeometryCollections are always the second geometry
+//   because their geometry_id is greater than the ids of StaticGeometries.
+//   intersects is implemented as ! disjoint.
+template <typename Geometry1, typename Geometry2, std::size_t DimensionCount, typename Tag1>
+struct disjoint<Geometry1, Geometry2, DimensionCount, Tag1, dynamic_geometry_tag, false>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::disjoint<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, std::size_t DimensionCount, typename Tag1>
+struct disjoint<Geometry1, Geometry2, DimensionCount, Tag1, geometry_collection_tag, false>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::disjoint<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1>
+struct covered_by<Geometry1, Geometry2, Tag1, dynamic_geometry_tag>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::covered_by_one<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag1>
+struct covered_by<Geometry1, Geometry2, Tag1, geometry_collection_tag>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::covered_by_one<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag2>
+struct covered_by<Geometry1, Geometry2, dynamic_geometry_tag, Tag2>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::covered_by<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+template <typename Geometry1, typename Geometry2, typename Tag2>
+struct covered_by<Geometry1, Geometry2, geometry_collection_tag, Tag2>
+{
+    template <typename Strategy>
+    static inline bool apply(Geometry1 const& geometry1, Geometry2 const& geometry2, Strategy const& )
+    {
+        return detail::collection_predicates::covered_by<Geometry1, Geometry2>::apply(geometry1, geometry2);
+    }
+};
+
+// NOTE: If both geometries are DynamicGeometries or GeometryCollections all
+//   StaticGeometries stored in the first one are checked.
+template <typename Geometry1, typename Geometry2>
+struct covered_by<Geometry1, Geometry2, dynamic_geometry_tag, dynamic_geometry_tag>
+    : covered_by<Geometry1, Geometry2, dynamic_geometry_tag, void>
+{};
+
+template <typename Geometry1, typename Geometry2>
+struct covered_by<Geometry1, Geometry2, dynamic_geometry_tag, geometry_collection_tag>
+    : covered_by<Geometry1, Geometry2, dynamic_geometry_tag, void>
+{};
+
+template <typename Geometry1, typename Geometry2>
+struct covered_by<Geometry1, Geometry2, geometry_collection_tag, dynamic_geometry_tag>
+    : covered_by<Geometry1, Geometry2, geometry_collection_tag, void>
+{};
+
+template <typename Geometry1, typename Geometry2>
+struct covered_by<Geometry1, Geometry2, geometry_collection_tag, geometry_collection_tag>
+    : covered_by<Geometry1, Geometry2, geometry_collection_tag, void>
+{};
+
+} // namespace dispatch
+
+}} // namespace boost::geometry
+
+#endif // PREDICATES_HPP
@@ -0,0 +1,472 @@
+#ifndef READ_WKT_HPP
+#define READ_WKT_HPP
+
+#include <cctype>
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+#include <boost/geometry/io/wkt/read.hpp>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace wkt_stream {
+
+enum keyword_id
+{
+    keyword_unknown,
+    keyword_point,
+    keyword_linestring,
+    keyword_polygon,
+    keyword_multi_point,
+    keyword_multi_linestring,
+    keyword_multi_polygon,
+    keyword_geometry_collection
+};
+
+inline keyword_id find_keyword(std::string const& word)
+{
+    if (word == "POINT") return keyword_point;
+    if (word == "LINESTRING") return keyword_linestring;
+    if (word == "POLYGON") return keyword_polygon;
+    if (word == "MULTIPOINT") return keyword_multi_point;
+    if (word == "MULTILINESTRING") return keyword_multi_linestring;
+    if (word == "MULTIPOLYGON") return keyword_multi_polygon;
+    if (word == "GEOMETRYCOLLECTION") return keyword_geometry_collection;
+    return keyword_unknown;
+}
+
+template <typename Tag>
+struct tag_keyword : std::integral_constant<keyword_id, keyword_unknown> {};
+template <>
+struct tag_keyword<point_tag> : std::integral_constant<keyword_id, keyword_point> {};
+template <>
+struct tag_keyword<linestring_tag> : std::integral_constant<keyword_id, keyword_linestring> {};
+template <>
+struct tag_keyword<polygon_tag> : std::integral_constant<keyword_id, keyword_polygon> {};
+template <>
+struct tag_keyword<multi_point_tag> : std::integral_constant<keyword_id, keyword_multi_point> {};
+template <>
+struct tag_keyword<multi_linestring_tag> : std::integral_constant<keyword_id, keyword_multi_linestring> {};
+template <>
+struct tag_keyword<multi_polygon_tag> : std::integral_constant<keyword_id, keyword_multi_polygon> {};
+template <>
+struct tag_keyword<geometry_collection_tag> : std::integral_constant<keyword_id, keyword_geometry_collection> {};
+
+// Characters read from a streambuf, buffered by the streambuf itself
+class streambuf_source
+{
+public:
+    explicit streambuf_source(std::streambuf & buffer)
+        : m_buffer(buffer)
+    {}
+
+    int peek() const
+    {
+        return m_buffer.sgetc();
+    }
+
+    void next()
+    {
+        m_buffer.sbumpc();
+    }
+
+private:
+    std::streambuf & m_buffer;
+};
+
+// Characters read from memory, e.g. a memory-mapped file
+class memory_source
+{
+public:
+    memory_source(char const* first, char const* last)
+        : m_it(first), m_end(last)
+    {}
+
+    int peek() const
+    {
+        return m_it != m_end
+             ? std::char_traits<char>::to_int_type(*m_it)
+             : std::char_traits<char>::eof();
+    }
+
+    void next()
+    {
+        ++m_it;
+    }
+
+    char const* position() const
+    {
+        return m_it;
+    }
+
+private:
+    char const* m_it;
+    char const* m_end;
+};
+
+// Reads tokens one by one from the Source so only the text of one StaticGeometry
+// is kept in memory at a time. The text of StaticGeometries is parsed by read_wkt
+// defined for these geometries and the StaticGeometries are moved into
+// GeometryCollections as soon as they are read.
+// NOTE: Tokens are read when needed so nothing after the geometry is read.
+template <typename Source>
+class parser
+{
+    // Size of the text of recent tokens passed into exceptions
+    static const std::size_t context_size = 100;
+
+public:
+    explicit parser(Source & source)
+        : m_source(source)
+    {}
+
+    template <typename Geometry>
+    void apply(Geometry & geometry)
+    {
+        geometry::clear(geometry);
+        keyword_id const keyword = read_keyword();
+        read(geometry, keyword, typename tag<Geometry>::type());
+    }
+
+    // Checks if there are no tokens after the geometry
+    void check_end()
+    {
+        if (! token().empty())
+        {
+            throw_exception("Too many tokens");
+        }
+    }
+
+private:
+    template <typename Geometry, typename Tag>
+    void read(Geometry & geometry, keyword_id keyword, Tag)
+    {
+        if (keyword != tag_keyword<Tag>::value)
+        {
+            throw_exception("Unexpected geometry type");
+        }
+        read_static(geometry);
+    }
+
+    template <typename Geometry>
+    void read(Geometry & geometry, keyword_id keyword, dynamic_geometry_tag)
+    {
+        read_element<typename traits::geometry_types<Geometry>::type>(keyword, [&](auto && g)
+        {
+            geometry = std::move(g);
+        });
+    }
+
+    template <typename Geometry>
+    void read(Geometry & geometry, keyword_id keyword, geometry_collection_tag)
+    {
+        if (keyword != keyword_geometry_collection)
+        {
+            throw_exception("Should start with 'GEOMETRYCOLLECTION'");
+        }
+        if (is_word("Z") || is_word("M") || is_word("ZM"))
+        {
+            consume();
+        }
+        if (is_word("EMPTY"))
+        {
+            consume();
+            return;
+        }
+
+        expect("(");
+        while (true)
+        {
+            keyword_id const element_keyword = read_keyword();
+            read_element<typename traits::geometry_types<Geometry>::type>(element_keyword, [&](auto && g)
+            {
+                range::emplace_back(geometry, std::move(g));
+            });
+            if (token() != ",")
+            {
+                break;
+            }
+            consume();
+        }
+        expect(")");
+    }
+
+    // Reads the StaticGeometry or GeometryCollection of the first type in TypeSequence
+    // matching the keyword and passes it into the function
+    template <typename TypeSequence, typename Function>
+    void read_element(keyword_id keyword, Function && function)
+    {
+        read_element<TypeSequence>(keyword, function, std::integral_constant<std::size_t, 0>());
+    }
+
+    template <typename TypeSequence, typename Function, std::size_t I>
+    void read_element(keyword_id keyword, Function & function, std::integral_constant<std::size_t, I>)
+    {
+        read_element<TypeSequence>(keyword, function, std::integral_constant<std::size_t, I>(),
+            std::integral_constant<bool, (I < util::sequence_size<TypeSequence>::value)>());
+    }
+
+    template <typename TypeSequence, typename Function, std::size_t I>
+    void read_element(keyword_id keyword, Function & function, std::integral_constant<std::size_t, I>,
+                      std::true_type /*in_sequence*/)
+    {
+        using geometry_t = typename util::sequence_element<I, TypeSequence>::type;
+        using tag_t = typename tag<geometry_t>::type;
+        if (keyword == tag_keyword<tag_t>::value)
+        {
+            geometry_t g;
+            read(g, keyword, tag_t());
+            function(std::move(g));
+        }
+        else
+        {
+            read_element<TypeSequence>(keyword, function, std::integral_constant<std::size_t, I + 1>());
+        }
+    }
+
+    template <typename TypeSequence, typename Function, std::size_t I>
+    void read_element(keyword_id , Function & , std::integral_constant<std::size_t, I>,
+                      std::false_type /*in_sequence*/)
+    {
+        throw_exception("Geometry type not in geometry_types");
+    }
+
+    // Collects the text of the StaticGeometry and parses it
+    template <typename Geometry>
+    void read_static(Geometry & geometry)
+    {
+        if (is_word("Z") || is_word("M") || is_word("ZM"))
+        {
+            append_token();
+        }
+        if (is_word("EMPTY"))
+        {
+            append_token();
+        }
+        else
+        {
+            if (token() != "(")
+            {
+                throw_exception("Expected '('");
+            }
+            std::size_t depth = 0;
+            do
+            {
+                if (token().empty())
+                {
+                    throw_exception("Expected ')'");
+                }
+                if (token() == "(")
+                {
+                    ++depth;
+                }
+                else if (token() == ")")
+                {
+                    --depth;
+                }
+                append_token();
+            }
+            while (depth > 0);
+        }
+        geometry::read_wkt(m_text, geometry);
+    }
+
+    keyword_id read_keyword()
+    {
+        if (token().empty())
+        {
+            throw_exception("Expected geometry type");
+        }
+        m_text = token();
+        for (char & c : m_text)
+        {
+            c = char(std::toupper(static_cast<unsigned char>(c)));
+        }
+        keyword_id const result = find_keyword(m_text);
+        if (result == keyword_unknown)
+        {
+            throw_exception("Unknown geometry type");
+        }
+        consume();
+        return result;
+    }
+
+    void append_token()
+    {
+        m_text += ' ';
+        m_text += token();
+        consume();
+    }
+
+    void expect(const char * expected)
+    {
+        if (token() != expected)
+        {
+            throw_exception(std::string("Expected '") + expected + "'");
+        }
+        consume();
+    }
+
+    bool is_word(const char * word)
+    {
+        std::string const& t = token();
+        std::size_t i = 0;
+        for (; i < t.size() && word[i] != '\0'; ++i)
+        {
+            if (std::toupper(static_cast<unsigned char>(t[i])) != word[i])
+            {
+                return false;
+            }
+        }
+        return i == t.size() && word[i] == '\0';
+    }
+
+    // The token is empty at the end of input
+    std::string const& token()
+    {
+        if (! m_has_token)
+        {
+            read_token();
+            m_has_token = true;
+        }
+        return m_token;
+    }
+
+    void consume()
+    {
+        m_has_token = false;
+    }
+
+    static bool is_separator(int c)
+    {
+        return c == '(' || c == ')' || c == ',';
+    }
+
+    static bool is_space(int c)
+    {
+        return c != std::char_traits<char>::eof()
+            && std::isspace(static_cast<unsigned char>(c));
+    }
+
+    void read_token()
+    {
+        m_token.clear();
+        int c = m_source.peek();
+        while (is_space(c))
+        {
+            m_source.next();
+            c = m_source.peek();
+        }
+        if (c == std::char_traits<char>::eof())
+        {
+            return;
+        }
+        if (is_separator(c))
+        {
+            m_token += char(c);
+            m_source.next();
+        }
+        else
+        {
+            while (c != std::char_traits<char>::eof() && ! is_space(c) && ! is_separator(c))
+            {
+                m_token += char(c);
+                m_source.next();
+                c = m_source.peek();
+            }
+        }
+
+        m_context += m_token;
+        m_context += ' ';
+        if (m_context.size() > 2 * context_size)
+        {
+            m_context.erase(0, m_context.size() - context_size);
+        }
+    }
+
+    void throw_exception(std::string const& message) const
+    {
+        BOOST_THROW_EXCEPTION(read_wkt_exception(message, m_context));
+    }
+
+    Source & m_source;
+    std::string m_token;
+    bool m_has_token = false;
+    std::string m_text;
+    std::string m_context;
+};
+
+template <typename Geometry>
+struct read_wkt
+{
+    static inline void apply(std::string const& wkt, Geometry & geometry)
+    {
+        memory_source source(wkt.data(), wkt.data() + wkt.size());
+        parser<memory_source> p(source);
+        p.apply(geometry);
+        p.check_end();
+    }
+};
+
+}} // namespace detail::wkt_stream
+
+namespace dispatch
+{
+
+template <typename Geometry>
+struct read_wkt<dynamic_geometry_tag, Geometry>
+    : detail::wkt_stream::read_wkt<Geometry>
+{};
+
+template <typename Geometry>
+struct read_wkt<geometry_collection_tag, Geometry>
+    : detail::wkt_stream::read_wkt<Geometry>
+{};
+
+} // namespace dispatch
+
+// Reads one geometry from the stream, e.g. each line of a file of WKTs:
+//     std::ifstream file("dump.wkt");
+//     while (file >> std::ws && file.peek() != EOF)
+//     {
+//         gc_t gc;
+//         read_wkt(file, gc);
+//     }
+// The text is read in chunks buffered by the stream. Elements of GeometryCollections
+// are stored with traits::emplace_back as soon as they are read so only the text of
+// one StaticGeometry is kept in memory at a time.
+// NOTE: Elements are stored as the first type in geometry_types matching the WKT.
+// NOTE: read_wkt_exception is thrown if the WKT is invalid. In this case the stream
+//   is left in the middle of the geometry.
+template <typename Geometry>
+inline void read_wkt(std::istream & stream, Geometry & geometry)
+{
+    std::istream::sentry sentry(stream);
+    if (! sentry)
+    {
+        BOOST_THROW_EXCEPTION(read_wkt_exception("Unable to read the stream", std::string()));
+    }
+    detail::wkt_stream::streambuf_source source(*stream.rdbuf());
+    detail::wkt_stream::parser<detail::wkt_stream::streambuf_source> p(source);
+    p.apply(geometry);
+}
+
+// Reads one geometry from the memory, e.g. a memory-mapped file, and returns the
+// pointer to the first character after it.
+template <typename Geometry>
+inline char const* read_wkt(char const* first, char const* last, Geometry & geometry)
+{
+    detail::wkt_stream::memory_source source(first, last);
+    detail::wkt_stream::parser<detail::wkt_stream::memory_source> p(source);
+    p.apply(geometry);
+    return source.position();
+}
+
+}} // namespace boost::geometry
+
+#endif // READ_WKT_HPP
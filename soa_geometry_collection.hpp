@@ -0,0 +1,324 @@
+#ifndef SOA_GEOMETRY_COLLECTION_HPP
+#define SOA_GEOMETRY_COLLECTION_HPP
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace soa_geometry_collection {
+
+// Index of the first of Geometries which is the same as Geometry, or if there is none,
+// the first one constructible from Geometry.
+template <typename Geometry, typename ...Geometries>
+struct type_index
+{
+    template <std::size_t I, typename ...Gs>
+    struct find_same
+        : std::integral_constant<std::size_t, I>
+    {};
+
+    template <std::size_t I, typename G, typename ...Gs>
+    struct find_same<I, G, Gs...>
+        : std::conditional_t
+            <
+                std::is_same<G, util::remove_cref_t<Geometry>>::value,
+                std::integral_constant<std::size_t, I>,
+                find_same<I + 1, Gs...>
+            >
+    {};
+
+    template <std::size_t I, typename ...Gs>
+    struct find_constructible
+        : std::integral_constant<std::size_t, I>
+    {};
+
+    template <std::size_t I, typename G, typename ...Gs>
+    struct find_constructible<I, G, Gs...>
+        : std::conditional_t
+            <
+                std::is_constructible<G, Geometry>::value,
+                std::integral_constant<std::size_t, I>,
+                find_constructible<I + 1, Gs...>
+            >
+    {};
+
+    static const std::size_t same = find_same<0, Geometries...>::value;
+    static const std::size_t value = same < sizeof...(Geometries)
+                                   ? same
+                                   : find_constructible<0, Geometries...>::value;
+};
+
+}} // namespace detail::soa_geometry_collection
+
+namespace model {
+
+// GeometryCollection storing StaticGeometries of each type in a separate contiguous
+// container. The order of elements is kept in a compact index of (type, position) pairs.
+// Passes over all geometries of one type can use geometries<Geometry>() directly.
+// NOTE: Geometries have to be complete types so nested soa_geometry_collections
+//   are not supported.
+template <typename ...Geometries>
+class soa_geometry_collection
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(sizeof...(Geometries) > 0,
+        "At least one Geometry type is required.",
+        util::type_sequence<Geometries...>);
+
+public:
+    // Position of an element
+    struct element
+    {
+        std::uint32_t type;
+        std::uint32_t index;
+    };
+
+private:
+    template <typename Collection>
+    class iterator_base
+        : public boost::iterator_facade
+            <
+                iterator_base<Collection>,
+                element const,
+                boost::random_access_traversal_tag
+            >
+    {
+    public:
+        iterator_base() = default;
+
+        iterator_base(Collection * collection, std::size_t position)
+            : m_collection(collection)
+            , m_position(position)
+        {}
+
+        // Conversion from iterator to const_iterator
+        template
+        <
+            typename C,
+            std::enable_if_t<std::is_convertible<C *, Collection *>::value, int> = 0
+        >
+        iterator_base(iterator_base<C> const& other)
+            : m_collection(other.m_collection)
+            , m_position(other.m_position)
+        {}
+
+        Collection & collection() const
+        {
+            return *m_collection;
+        }
+
+    private:
+        friend class boost::iterator_core_access;
+        template <typename C> friend class iterator_base;
+
+        element const& dereference() const
+        {
+            return m_collection->m_elements[m_position];
+        }
+
+        template <typename C>
+        bool equal(iterator_base<C> const& other) const
+        {
+            return m_position == other.m_position;
+        }
+
+        void increment() { ++m_position; }
+        void decrement() { --m_position; }
+        void advance(std::ptrdiff_t n) { m_position += n; }
+
+        template <typename C>
+        std::ptrdiff_t distance_to(iterator_base<C> const& other) const
+        {
+            return std::ptrdiff_t(other.m_position) - std::ptrdiff_t(m_position);
+        }
+
+        Collection * m_collection = nullptr;
+        std::size_t m_position = 0;
+    };
+
+public:
+    using value_type = element;
+    using size_type = std::size_t;
+    using iterator = iterator_base<soa_geometry_collection>;
+    using const_iterator = iterator_base<soa_geometry_collection const>;
+
+    soa_geometry_collection() = default;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_elements.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_elements.size()); }
+
+    size_type size() const { return m_elements.size(); }
+    bool empty() const { return m_elements.empty(); }
+
+    template <std::size_t I>
+    auto & geometries() { return std::get<I>(m_geometries); }
+    template <std::size_t I>
+    auto const& geometries() const { return std::get<I>(m_geometries); }
+
+    template <typename Geometry>
+    auto & geometries()
+    {
+        return geometries<geometry::detail::soa_geometry_collection::type_index<Geometry, Geometries...>::same>();
+    }
+    template <typename Geometry>
+    auto const& geometries() const
+    {
+        return geometries<geometry::detail::soa_geometry_collection::type_index<Geometry, Geometries...>::same>();
+    }
+
+    std::vector<element> const& elements() const { return m_elements; }
+
+    void reserve(size_type n)
+    {
+        m_elements.reserve(n);
+    }
+
+    size_type capacity() const
+    {
+        return m_elements.capacity();
+    }
+
+    // Stores the Geometry in the container of the same type or of the first type
+    // constructible from Geometry.
+    template <typename Geometry>
+    void emplace_back(Geometry && geometry)
+    {
+        static const std::size_t I = geometry::detail::soa_geometry_collection::type_index<Geometry, Geometries...>::value;
+        BOOST_GEOMETRY_STATIC_ASSERT(I < sizeof...(Geometries),
+            "This Geometry type can't be stored in this collection.",
+            Geometry);
+
+        auto & container = std::get<I>(m_geometries);
+        container.emplace_back(std::forward<Geometry>(geometry));
+        try
+        {
+            m_elements.push_back(element{ std::uint32_t(I), std::uint32_t(container.size() - 1) });
+        }
+        catch (...)
+        {
+            container.pop_back();
+            throw;
+        }
+    }
+
+    void clear()
+    {
+        clear_geometries(std::make_index_sequence<sizeof...(Geometries)>());
+        m_elements.clear();
+    }
+
+private:
+    template <std::size_t ...Is>
+    void clear_geometries(std::index_sequence<Is...>)
+    {
+        int dummy[] = { (std::get<Is>(m_geometries).clear(), 0)... };
+        boost::ignore_unused(dummy);
+    }
+
+    std::tuple<std::vector<Geometries>...> m_geometries;
+    std::vector<element> m_elements;
+};
+
+} // namespace model
+
+namespace traits {
+
+template <typename ...Geometries>
+struct tag<model::soa_geometry_collection<Geometries...>>
+{
+    typedef geometry_collection_tag type;
+};
+
+template <typename ...Geometries>
+struct geometry_types<model::soa_geometry_collection<Geometries...>>
+{
+    typedef util::type_sequence<Geometries...> type;
+};
+
+template <typename ...Geometries>
+struct grouped_storage<model::soa_geometry_collection<Geometries...>>
+    : std::true_type
+{};
+
+template <typename ...Geometries>
+struct visit_iterator<model::soa_geometry_collection<Geometries...>>
+{
+    template <typename Function, typename Iterator>
+    static void apply(Function && function, Iterator iterator)
+    {
+        apply(function, iterator, std::make_index_sequence<sizeof...(Geometries)>());
+    }
+
+private:
+    template <typename Function, typename Iterator, std::size_t ...Is>
+    static void apply(Function & function, Iterator const& iterator, std::index_sequence<Is...>)
+    {
+        using handler_t = void (*)(Function &, Iterator const&);
+        static const handler_t handlers[] = { &call<Is, Function, Iterator>... };
+        handlers[iterator->type](function, iterator);
+    }
+
+    template <std::size_t I, typename Function, typename Iterator>
+    static void call(Function & function, Iterator const& iterator)
+    {
+        function(iterator.collection().template geometries<I>()[iterator->index]);
+    }
+};
+
+template <typename ...Geometries>
+struct emplace_back<model::soa_geometry_collection<Geometries...>>
+{
+    template <typename Geometry>
+    static inline void apply(model::soa_geometry_collection<Geometries...> & range,
+                             Geometry && geometry)
+    {
+        range.emplace_back(std::forward<Geometry>(geometry));
+    }
+};
+
+} // namespace traits
+
+namespace dispatch
+{
+
+// Ranges of geometries of each type are stored contiguously
+template <typename ...Geometries>
+struct visit_grouped<model::soa_geometry_collection<Geometries...>, geometry_collection_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        return apply<0>(function, geom);
+    }
+
+private:
+    template <std::size_t I, typename F, typename Geom, std::enable_if_t<(I < sizeof...(Geometries)), int> = 0>
+    static bool apply(F & function, Geom & geom)
+    {
+        auto & geometries = geom.template geometries<I>();
+        if (! geometries.empty() && ! detail::call_visit_function(function, geometries))
+        {
+            return false;
+        }
+        return apply<I + 1>(function, geom);
+    }
+    template <std::size_t I, typename F, typename Geom, std::enable_if_t<(I >= sizeof...(Geometries)), int> = 0>
+    static bool apply(F & , Geom & )
+    {
+        return true;
+    }
+};
+
+} // namespace dispatch
+
+}} // namespace boost::geometry
+
+#endif // SOA_GEOMETRY_COLLECTION_HPP
@@ -0,0 +1,502 @@
+#ifndef VISIT_PARALLEL_HPP
+#define VISIT_PARALLEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+namespace detail { namespace visit_parallel {
+
+// Worker threads shared by all parallel traversals so threads are not created and
+// joined in each call. Workers are added when more threads are requested than the
+// pool has and are joined at program exit.
+class thread_pool
+{
+    // State of the jobs passed in one call of run()
+    struct batch
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::size_t running = 0;
+        bool closed = false;
+    };
+
+    // Stops the jobs of a batch which were not started yet and waits for the others
+    struct batch_guard
+    {
+        ~batch_guard()
+        {
+            std::unique_lock<std::mutex> lock(b->mutex);
+            b->closed = true;
+            b->finished.wait(lock, [this]() { return b->running == 0; });
+        }
+
+        std::shared_ptr<batch> b;
+    };
+
+public:
+    static thread_pool & instance()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+        m_available.notify_all();
+        for (std::thread & t : m_threads)
+        {
+            t.join();
+        }
+    }
+
+    // Calls job(i) for i in [1, count) in the workers and job(0) in the calling thread,
+    // then waits for the jobs started by the workers. Jobs not started before job(0)
+    // returns are not called at all so job(0) has to be able to do all of the work.
+    // This way nested calls, e.g. from a job, never wait for busy workers.
+    // NOTE: If a worker can't be created the jobs are run by fewer workers.
+    // NOTE: The job can't throw.
+    template <typename Job>
+    void run(std::size_t count, Job & job)
+    {
+        batch_guard const guard{ std::make_shared<batch>() };
+        if (count > 1)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            add_workers(count - 1);
+            for (std::size_t i = 1; i < count; ++i)
+            {
+                std::shared_ptr<batch> const b = guard.b;
+                m_jobs.emplace_back([b, &job, i]()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(b->mutex);
+                        if (b->closed)
+                        {
+                            return;
+                        }
+                        ++b->running;
+                    }
+                    job(i);
+                    std::lock_guard<std::mutex> lock(b->mutex);
+                    --b->running;
+                    b->finished.notify_all();
+                });
+            }
+        }
+        m_available.notify_all();
+        job(0);
+    }
+
+private:
+    thread_pool() = default;
+
+    void add_workers(std::size_t count)
+    {
+        while (m_threads.size() < count)
+        {
+            try
+            {
+                m_threads.emplace_back([this]() { work(); });
+            }
+            catch (std::system_error const& )
+            {
+                // The workers created so far are used
+                return;
+            }
+        }
+    }
+
+    void work()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_available.wait(lock, [this]() { return m_exit || ! m_jobs.empty(); });
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_available;
+    std::deque<std::function<void()>> m_jobs;
+    std::vector<std::thread> m_threads;
+    bool m_exit = false;
+};
+
+// A range of elements of either the top-most GeometryCollection or a nested one
+template <typename Root, typename Nested>
+struct task
+{
+    Root * root;
+    Nested * nested;
+    std::size_t first;
+    std::size_t last;
+};
+
+// Tasks of one worker. The owner takes the most recently pushed task, other workers
+// steal the oldest one which is likely the biggest piece of work.
+template <typename Task>
+class task_queue
+{
+public:
+    void push(Task const& task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+
+    bool pop(Task & task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty())
+        {
+            return false;
+        }
+        task = m_tasks.back();
+        m_tasks.pop_back();
+        return true;
+    }
+
+    bool steal(Task & task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty())
+        {
+            return false;
+        }
+        task = m_tasks.front();
+        m_tasks.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<Task> m_tasks;
+};
+
+template <typename Function, typename GeometryCollection>
+class traversal
+{
+    using nested_t = typename detail::nested_geometry_collection<util::remove_cref_t<GeometryCollection>>::type;
+    using gc_t = util::transcribe_const_t
+        <
+            GeometryCollection,
+            std::conditional_t<std::is_void<nested_t>::value, util::remove_cref_t<GeometryCollection>, nested_t>
+        >;
+    using task_t = task<GeometryCollection, gc_t>;
+
+    // Number of elements processed by a worker before other workers can take over
+    static const std::size_t grain_size = 1024;
+    // Smaller nested GeometryCollections are traversed in place, up to this depth
+    static const std::size_t max_inline_depth = 64;
+    // Number of failed attempts to take a task before an idle thread blocks
+    static const std::size_t max_spin_count = 64;
+
+public:
+    explicit traversal(std::vector<Function> & functions)
+        : m_functions(functions)
+        , m_pending(0)
+        , m_queued(0)
+        , m_waiting(0)
+        , m_stop(false)
+    {
+        for (std::size_t i = 0; i < m_functions.size(); ++i)
+        {
+            m_queues.emplace_back(new task_queue<task_t>());
+        }
+    }
+
+    bool apply(GeometryCollection & gc)
+    {
+        push_tasks(0, &gc, nullptr, boost::size(gc));
+
+        // work(0) processes all tasks if other workers are busy
+        auto job = [this](std::size_t id) { work(id); };
+        thread_pool::instance().run(m_functions.size(), job);
+
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+
+        return ! m_stop.load();
+    }
+
+private:
+    void push_tasks(std::size_t id, GeometryCollection * root, gc_t * nested, std::size_t size)
+    {
+        for (std::size_t first = 0; first < size; first += grain_size)
+        {
+            std::size_t const last = (std::min)(first + grain_size, size);
+            m_pending.fetch_add(1);
+            m_queued.fetch_add(1);
+            try
+            {
+                m_queues[id]->push(task_t{ root, nested, first, last });
+            }
+            catch (...)
+            {
+                // The task was not pushed so it's not counted, otherwise workers
+                // would wait for it forever. Workers are woken up for the tasks
+                // pushed so far or to finish.
+                m_queued.fetch_sub(1);
+                m_pending.fetch_sub(1);
+                notify_idle();
+                throw;
+            }
+            // Spread the top-most GeometryCollection between workers
+            if (root != nullptr)
+            {
+                id = (id + 1) % m_queues.size();
+            }
+        }
+        notify_idle();
+    }
+
+    // Wakes up threads blocked in wait_idle(). The mutex is locked so the notification
+    // is not lost between checking the condition and blocking.
+    void notify_idle()
+    {
+        if (m_waiting.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_idle_mutex);
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    // Blocks the thread until a task is pushed or all tasks are processed
+    void wait_idle()
+    {
+        std::unique_lock<std::mutex> lock(m_idle_mutex);
+        m_waiting.fetch_add(1);
+        m_idle.wait(lock, [this]() { return m_pending.load() == 0 || m_queued.load() > 0; });
+        m_waiting.fetch_sub(1);
+    }
+
+    void work(std::size_t id)
+    {
+        task_t t;
+        std::size_t spin_count = 0;
+        while (m_pending.load() > 0)
+        {
+            if (m_queues[id]->pop(t) || steal(id, t))
+            {
+                m_queued.fetch_sub(1);
+                spin_count = 0;
+                if (! m_stop.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        if (t.root != nullptr)
+                        {
+                            process(id, *t.root, t.first, t.last, 0);
+                        }
+                        else
+                        {
+                            process(id, *t.nested, t.first, t.last, 0);
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(m_exception_mutex);
+                        if (! m_exception)
+                        {
+                            m_exception = std::current_exception();
+                        }
+                        m_stop.store(true);
+                    }
+                }
+                if (m_pending.fetch_sub(1) == 1)
+                {
+                    notify_idle();
+                }
+            }
+            else if (++spin_count < max_spin_count)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                wait_idle();
+                spin_count = 0;
+            }
+        }
+    }
+
+    bool steal(std::size_t id, task_t & t)
+    {
+        for (std::size_t i = 1; i < m_queues.size(); ++i)
+        {
+            if (m_queues[(id + i) % m_queues.size()]->steal(t))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Geom>
+    void process(std::size_t id, Geom & gc, std::size_t first, std::size_t last, std::size_t depth)
+    {
+        auto it = boost::begin(gc) + first;
+        for (std::size_t i = first; i < last && ! m_stop.load(std::memory_order_relaxed); ++i, ++it)
+        {
+            traits::visit_iterator<util::remove_cref_t<Geom>>::apply([&](auto & g)
+            {
+                visit_or_push(id, g, depth);
+            }, it);
+        }
+    }
+
+    template <typename Geom, std::enable_if_t<util::is_geometry_collection<Geom>::value, int> = 0>
+    void visit_or_push(std::size_t id, Geom & g, std::size_t depth)
+    {
+        std::size_t const size = boost::size(g);
+        if (size <= grain_size && depth < max_inline_depth)
+        {
+            process(id, g, 0, size, depth + 1);
+        }
+        else
+        {
+            push_tasks(id, nullptr, boost::addressof(g), size);
+        }
+    }
+    template <typename Geom, std::enable_if_t<! util::is_geometry_collection<Geom>::value, int> = 0>
+    void visit_or_push(std::size_t id, Geom & g, std::size_t )
+    {
+        if (! detail::call_visit_function(m_functions[id], g))
+        {
+            m_stop.store(true);
+        }
+    }
+
+    std::vector<Function> & m_functions;
+    std::vector<std::unique_ptr<task_queue<task_t>>> m_queues;
+    // Tasks pushed and not processed yet
+    std::atomic<std::size_t> m_pending;
+    // Tasks pushed and not taken from the queues yet
+    std::atomic<std::size_t> m_queued;
+    std::atomic<std::size_t> m_waiting;
+    std::mutex m_idle_mutex;
+    std::condition_variable m_idle;
+    std::atomic<bool> m_stop;
+    std::mutex m_exception_mutex;
+    std::exception_ptr m_exception;
+};
+
+}} // namespace detail::visit_parallel
+
+namespace dispatch
+{
+
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct visit_parallel
+{
+    template <typename Functions, typename G>
+    static bool apply(Functions & functions, G & g)
+    {
+        return detail::call_visit_function(functions.front(), g);
+    }
+};
+
+template <typename Geometry>
+struct visit_parallel<Geometry, void>
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry);
+};
+
+template <typename Geometry>
+struct visit_parallel<Geometry, dynamic_geometry_tag>
+{
+    template <typename Functions, typename Geom>
+    static bool apply(Functions & functions, Geom & geom)
+    {
+        bool result = true;
+        traits::visit<util::remove_cref_t<Geom>>::apply([&](auto & g)
+        {
+            result = visit_parallel<decltype(g)>::apply(functions, g);
+        }, geom);
+        return result;
+    }
+};
+
+template <typename Geometry>
+struct visit_parallel<Geometry, geometry_collection_tag>
+{
+    template <typename Functions, typename Geom>
+    static bool apply(Functions & functions, Geom & geom)
+    {
+        using function_t = typename Functions::value_type;
+        return detail::visit_parallel::traversal<function_t, Geom>(functions).apply(geom);
+    }
+};
+
+} // namespace dispatch
+
+// NOTE: Traverses the elements of the top-most GeometryCollection and of nested
+//   GeometryCollections in parallel, in no particular order. GeometryCollections
+//   have to be random access ranges.
+// NOTE: The function is copied for each thread and the copies are called concurrently
+//   for different StaticGeometries. Nothing is shared between the copies by the
+//   algorithm, so they can accumulate results without synchronization. The copies are
+//   returned so the per-thread results can be reduced, e.g.:
+//     auto counters = visit_parallel(counter(), gc);
+//     std::size_t count = 0;
+//     for (auto const& c : counters.first)
+//         count += c.count;
+//   Copies of lambdas capturing by reference share the captured objects, so these
+//   have to be synchronized by the caller.
+// NOTE: The copies and a flag are returned as a pair, the flag is false if the function
+//   returned false and the traversal was stopped as soon as possible. Other threads
+//   may still call their copies of the function for a few elements.
+// NOTE: If threads is 0 std::thread::hardware_concurrency() threads are used,
+//   including the calling thread. The threads other than the calling one are taken
+//   from a pool of workers shared by all parallel traversals and created once.
+template <typename UnaryFunction, typename Geometry>
+inline std::pair<std::vector<UnaryFunction>, bool> visit_parallel(UnaryFunction const& function,
+                                                                  Geometry & geometry,
+                                                                  std::size_t threads = 0)
+{
+    if (threads == 0)
+    {
+        threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    std::vector<UnaryFunction> functions(threads, function);
+    bool const result = dispatch::visit_parallel<Geometry>::apply(functions, geometry);
+    return std::make_pair(std::move(functions), result);
+}
+
+
+}} // namespace boost::geometry
+
+#endif // VISIT_PARALLEL_HPP
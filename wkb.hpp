@@ -0,0 +1,709 @@
+#ifndef WKB_HPP
+#define WKB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/core/ignore_unused.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/geometry/core/exception.hpp>
+#include <boost/geometry/util/range.hpp>
+
+#include "geometry.hpp"
+
+namespace boost { namespace geometry {
+
+// Exception thrown if WKB is invalid or not supported
+struct read_wkb_exception : public geometry::exception
+{
+    explicit read_wkb_exception(std::string const& message)
+        : m_message(message)
+    {}
+
+    virtual const char * what() const throw()
+    {
+        return m_message.c_str();
+    }
+
+private:
+    std::string m_message;
+};
+
+namespace detail { namespace wkb {
+
+enum geometry_type
+{
+    wkb_unknown = 0,
+    wkb_point = 1,
+    wkb_linestring = 2,
+    wkb_polygon = 3,
+    wkb_multi_point = 4,
+    wkb_multi_linestring = 5,
+    wkb_multi_polygon = 6,
+    wkb_geometry_collection = 7
+};
+
+// EWKB flags stored in the type
+static const std::uint32_t ewkb_z = 0x80000000;
+static const std::uint32_t ewkb_m = 0x40000000;
+static const std::uint32_t ewkb_srid = 0x20000000;
+
+template <typename Tag>
+struct tag_type : std::integral_constant<geometry_type, wkb_unknown> {};
+template <>
+struct tag_type<point_tag> : std::integral_constant<geometry_type, wkb_point> {};
+template <>
+struct tag_type<linestring_tag> : std::integral_constant<geometry_type, wkb_linestring> {};
+template <>
+struct tag_type<polygon_tag> : std::integral_constant<geometry_type, wkb_polygon> {};
+template <>
+struct tag_type<multi_point_tag> : std::integral_constant<geometry_type, wkb_multi_point> {};
+template <>
+struct tag_type<multi_linestring_tag> : std::integral_constant<geometry_type, wkb_multi_linestring> {};
+template <>
+struct tag_type<multi_polygon_tag> : std::integral_constant<geometry_type, wkb_multi_polygon> {};
+template <>
+struct tag_type<geometry_collection_tag> : std::integral_constant<geometry_type, wkb_geometry_collection> {};
+
+// Byte order and type preceding every geometry, both in WKB and EWKB
+struct header
+{
+    geometry_type type;
+    bool has_z;
+    bool has_m;
+};
+
+// Value stored at the pointer, in the byte order of the buffer
+template <typename T>
+inline T load(std::uint8_t const* ptr, bool swap)
+{
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return swap ? boost::endian::endian_reverse(value) : value;
+}
+
+template <>
+inline double load<double>(std::uint8_t const* ptr, bool swap)
+{
+    std::uint64_t const bits = load<std::uint64_t>(ptr, swap);
+    double value;
+    std::memcpy(&value, &bits, sizeof(double));
+    return value;
+}
+
+// Byte order 0 is big endian, 1 is little endian
+inline bool swap_bytes(std::uint8_t order)
+{
+    return (order == 1) != (boost::endian::order::native == boost::endian::order::little);
+}
+
+// Sets the type and dimensions stored in WKB or EWKB type and returns true if
+// it's followed by SRID
+inline bool decode_type(std::uint32_t type, header & h)
+{
+    std::uint32_t const base = type & 0x0FFFFFFF;
+    std::uint32_t const iso_dimensions = base / 1000;
+    h.type = static_cast<geometry_type>(base % 1000);
+    h.has_z = (type & ewkb_z) != 0 || iso_dimensions == 1 || iso_dimensions == 3;
+    h.has_m = (type & ewkb_m) != 0 || iso_dimensions == 2 || iso_dimensions == 3;
+    if (h.type < wkb_point || h.type > wkb_geometry_collection || iso_dimensions > 3)
+    {
+        BOOST_THROW_EXCEPTION(read_wkb_exception("Unsupported geometry type"));
+    }
+    return (type & ewkb_srid) != 0;
+}
+
+// Size of a point in bytes
+inline std::size_t point_size(header const& h)
+{
+    return 8 * (2 + (h.has_z ? 1 : 0) + (h.has_m ? 1 : 0));
+}
+
+// Reads values directly from the buffer, e.g. a memory-mapped file
+class reader
+{
+public:
+    reader(std::uint8_t const* first, std::uint8_t const* last)
+        : m_it(first), m_end(last)
+    {}
+
+    std::uint8_t const* position() const
+    {
+        return m_it;
+    }
+
+    header read_header()
+    {
+        check(1);
+        std::uint8_t const order = *m_it++;
+        if (order > 1)
+        {
+            BOOST_THROW_EXCEPTION(read_wkb_exception("Invalid byte order"));
+        }
+        m_swap = swap_bytes(order);
+
+        header result;
+        if (decode_type(read_uint32(), result))
+        {
+            // SRID is ignored
+            read_uint32();
+        }
+        return result;
+    }
+
+    void skip(std::size_t size)
+    {
+        check(size);
+        m_it += size;
+    }
+
+    // Number of elements, each taking at least min_size bytes
+    std::size_t read_count(std::size_t min_size)
+    {
+        std::size_t const count = read_uint32();
+        if (count > std::size_t(m_end - m_it) / min_size)
+        {
+            BOOST_THROW_EXCEPTION(read_wkb_exception("Invalid number of elements"));
+        }
+        return count;
+    }
+
+    std::uint32_t read_uint32()
+    {
+        return read<std::uint32_t>();
+    }
+
+    double read_double()
+    {
+        return read<double>();
+    }
+
+private:
+    template <typename T>
+    T read()
+    {
+        check(sizeof(T));
+        T const value = load<T>(m_it, m_swap);
+        m_it += sizeof(T);
+        return value;
+    }
+
+    void check(std::size_t size) const
+    {
+        if (std::size_t(m_end - m_it) < size)
+        {
+            BOOST_THROW_EXCEPTION(read_wkb_exception("Unexpected end of WKB"));
+        }
+    }
+
+    std::uint8_t const* m_it;
+    std::uint8_t const* m_end;
+    bool m_swap = false;
+};
+
+// Appends little endian values to the vector. If srid is set the header of the
+// top-most geometry is written in EWKB format.
+class writer
+{
+public:
+    explicit writer(std::vector<std::uint8_t> & bytes)
+        : m_bytes(bytes)
+    {}
+
+    writer(std::vector<std::uint8_t> & bytes, std::uint32_t srid)
+        : m_bytes(bytes), m_srid(srid), m_ewkb(true), m_write_srid(true)
+    {}
+
+    void write_header(geometry_type type, bool has_z)
+    {
+        m_bytes.push_back(1);
+        if (m_ewkb)
+        {
+            write_uint32(type | (has_z ? ewkb_z : 0) | (m_write_srid ? ewkb_srid : 0));
+            if (m_write_srid)
+            {
+                write_uint32(m_srid);
+                m_write_srid = false;
+            }
+        }
+        else
+        {
+            write_uint32(type + (has_z ? 1000 : 0));
+        }
+    }
+
+    void write_uint32(std::uint32_t value)
+    {
+        write(boost::endian::native_to_little(value));
+    }
+
+    void write_count(std::size_t count)
+    {
+        write_uint32(static_cast<std::uint32_t>(count));
+    }
+
+    void write_double(double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(double));
+        write(boost::endian::native_to_little(bits));
+    }
+
+private:
+    template <typename T>
+    void write(T value)
+    {
+        std::uint8_t const* bytes = reinterpret_cast<std::uint8_t const*>(&value);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    std::vector<std::uint8_t> & m_bytes;
+    std::uint32_t m_srid = 0;
+    bool m_ewkb = false;
+    bool m_write_srid = false;
+};
+
+template <typename Range, typename Enable = void>
+struct reserve
+{
+    static void apply(Range & , std::size_t )
+    {}
+};
+
+template <typename Range>
+struct reserve<Range, decltype(void(std::declval<Range &>().reserve(std::size_t(0))))>
+{
+    static void apply(Range & range, std::size_t size)
+    {
+        range.reserve(size);
+    }
+};
+
+template <typename Geometry>
+inline void check_type(header const& h, Geometry const& )
+{
+    if (h.type != tag_type<typename tag<Geometry>::type>::value)
+    {
+        BOOST_THROW_EXCEPTION(read_wkb_exception("Unexpected geometry type"));
+    }
+}
+
+template <typename Point, std::size_t ...Is>
+inline void read_point(reader & r, header const& h, Point & point, std::index_sequence<Is...>)
+{
+    using coordinate_t = typename coordinate_type<Point>::type;
+    static const std::size_t dimension = sizeof...(Is);
+
+    double values[4] = { r.read_double(), r.read_double(), 0, 0 };
+    std::size_t count = 2;
+    if (h.has_z)
+    {
+        values[count++] = r.read_double();
+    }
+    if (h.has_m)
+    {
+        r.read_double();
+    }
+
+    // Coordinates not stored in WKB are set to 0, M is ignored
+    int dummy[] = { (geometry::set<Is>(point, coordinate_t(Is < count ? values[Is] : 0)), 0)... };
+    boost::ignore_unused(dummy);
+    BOOST_GEOMETRY_STATIC_ASSERT(dimension <= 3,
+        "Points with more than 3 dimensions are not supported.",
+        Point);
+}
+
+template <typename Point>
+inline void read_point(reader & r, header const& h, Point & point)
+{
+    read_point(r, h, point, std::make_index_sequence<dimension<Point>::value>());
+}
+
+// Points stored in a linestring or a ring, the memory of the range is reused
+template <typename Range>
+inline void read_points(reader & r, header const& h, Range & range)
+{
+    using point_t = typename boost::range_value<Range>::type;
+    std::size_t const count = r.read_count(point_size(h));
+    range::clear(range);
+    reserve<Range>::apply(range, count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        point_t point;
+        read_point(r, h, point);
+        range::push_back(range, point);
+    }
+}
+
+template <typename Point, std::size_t ...Is>
+inline void write_point(writer & w, Point const& point, std::index_sequence<Is...>)
+{
+    int dummy[] = { (w.write_double(double(geometry::get<Is>(point))), 0)... };
+    boost::ignore_unused(dummy);
+}
+
+template <typename Point>
+inline void write_point(writer & w, Point const& point)
+{
+    BOOST_GEOMETRY_STATIC_ASSERT(dimension<Point>::value <= 3,
+        "Points with more than 3 dimensions are not supported.",
+        Point);
+    write_point(w, point, std::make_index_sequence<dimension<Point>::value>());
+}
+
+template <typename Range>
+inline void write_points(writer & w, Range const& range)
+{
+    w.write_count(boost::size(range));
+    for (auto const& point : range)
+    {
+        write_point(w, point);
+    }
+}
+
+template <typename Geometry>
+inline bool has_z(Geometry const& )
+{
+    return dimension<Geometry>::value >= 3;
+}
+
+}} // namespace detail::wkb
+
+namespace dispatch
+{
+
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct read_wkb
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry, Tag);
+};
+
+template <typename Point>
+struct read_wkb<Point, point_tag>
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, Point & point)
+    {
+        detail::wkb::check_type(h, point);
+        detail::wkb::read_point(r, h, point);
+    }
+};
+
+template <typename Linestring>
+struct read_wkb<Linestring, linestring_tag>
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, Linestring & linestring)
+    {
+        detail::wkb::check_type(h, linestring);
+        detail::wkb::read_points(r, h, linestring);
+    }
+};
+
+template <typename Polygon>
+struct read_wkb<Polygon, polygon_tag>
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, Polygon & polygon)
+    {
+        detail::wkb::check_type(h, polygon);
+        std::size_t const count = r.read_count(4);
+        if (count == 0)
+        {
+            geometry::clear(polygon);
+            return;
+        }
+
+        typename ring_return_type<Polygon>::type exterior = geometry::exterior_ring(polygon);
+        detail::wkb::read_points(r, h, exterior);
+        typename interior_return_type<Polygon>::type interiors = geometry::interior_rings(polygon);
+        range::resize(interiors, count - 1);
+        for (auto & ring : interiors)
+        {
+            detail::wkb::read_points(r, h, ring);
+        }
+    }
+};
+
+// Elements of multi-geometries are read in place so their memory is reused
+template <typename MultiGeometry>
+struct read_wkb_multi
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, MultiGeometry & multi)
+    {
+        using value_t = typename boost::range_value<MultiGeometry>::type;
+        detail::wkb::check_type(h, multi);
+        std::size_t const count = r.read_count(5);
+        range::resize(multi, count);
+        for (auto & element : multi)
+        {
+            detail::wkb::header const element_header = r.read_header();
+            read_wkb<value_t>::apply(r, element_header, element);
+        }
+    }
+};
+
+template <typename MultiPoint>
+struct read_wkb<MultiPoint, multi_point_tag>
+    : read_wkb_multi<MultiPoint>
+{};
+
+template <typename MultiLinestring>
+struct read_wkb<MultiLinestring, multi_linestring_tag>
+    : read_wkb_multi<MultiLinestring>
+{};
+
+template <typename MultiPolygon>
+struct read_wkb<MultiPolygon, multi_polygon_tag>
+    : read_wkb_multi<MultiPolygon>
+{};
+
+} // namespace dispatch
+
+namespace detail { namespace wkb {
+
+// Reads the geometry of the first type in TypeSequence matching the header
+// and passes it into the function
+template
+<
+    typename TypeSequence,
+    std::size_t I = 0,
+    std::size_t N = util::sequence_size<TypeSequence>::value
+>
+struct read_element
+{
+    using geometry_t = typename util::sequence_element<I, TypeSequence>::type;
+    static const geometry_type type = tag_type<typename tag<geometry_t>::type>::value;
+
+    template <typename Function>
+    static inline void apply(reader & r, header const& h, Function & function)
+    {
+        apply(r, h, function, std::integral_constant<bool, type != wkb_unknown>());
+    }
+
+private:
+    template <typename Function>
+    static inline void apply(reader & r, header const& h, Function & function, std::true_type /*supported*/)
+    {
+        if (h.type == type)
+        {
+            geometry_t g;
+            dispatch::read_wkb<geometry_t>::apply(r, h, g);
+            function(std::move(g));
+        }
+        else
+        {
+            read_element<TypeSequence, I + 1, N>::apply(r, h, function);
+        }
+    }
+
+    template <typename Function>
+    static inline void apply(reader & r, header const& h, Function & function, std::false_type /*supported*/)
+    {
+        read_element<TypeSequence, I + 1, N>::apply(r, h, function);
+    }
+};
+
+template <typename TypeSequence, std::size_t N>
+struct read_element<TypeSequence, N, N>
+{
+    template <typename Function>
+    static inline void apply(reader & , header const& , Function & )
+    {
+        BOOST_THROW_EXCEPTION(read_wkb_exception("Geometry type not in geometry_types"));
+    }
+};
+
+}} // namespace detail::wkb
+
+namespace dispatch
+{
+
+template <typename Geometry>
+struct read_wkb<Geometry, dynamic_geometry_tag>
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, Geometry & geometry)
+    {
+        auto assign = [&](auto && g)
+        {
+            geometry = std::move(g);
+        };
+        detail::wkb::read_element
+            <
+                typename traits::geometry_types<Geometry>::type
+            >::apply(r, h, assign);
+    }
+};
+
+// Elements are moved into the GeometryCollection as soon as they are read
+template <typename Geometry>
+struct read_wkb<Geometry, geometry_collection_tag>
+{
+    static inline void apply(detail::wkb::reader & r, detail::wkb::header const& h, Geometry & geometry)
+    {
+        detail::wkb::check_type(h, geometry);
+        std::size_t const count = r.read_count(5);
+        geometry::clear(geometry);
+        detail::wkb::reserve<Geometry>::apply(geometry, count);
+        auto emplace = [&](auto && g)
+        {
+            range::emplace_back(geometry, std::move(g));
+        };
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            detail::wkb::header const element_header = r.read_header();
+            detail::wkb::read_element
+                <
+                    typename traits::geometry_types<Geometry>::type
+                >::apply(r, element_header, emplace);
+        }
+    }
+};
+
+
+template <typename Geometry, typename Tag = typename tag<Geometry>::type>
+struct write_wkb
+{
+    BOOST_GEOMETRY_STATIC_ASSERT_FALSE(
+        "Not implemented for this Geometry type.",
+        Geometry, Tag);
+};
+
+template <typename Point>
+struct write_wkb<Point, point_tag>
+{
+    static inline void apply(detail::wkb::writer & w, Point const& point)
+    {
+        w.write_header(detail::wkb::wkb_point, detail::wkb::has_z(point));
+        detail::wkb::write_point(w, point);
+    }
+};
+
+template <typename Linestring>
+struct write_wkb<Linestring, linestring_tag>
+{
+    static inline void apply(detail::wkb::writer & w, Linestring const& linestring)
+    {
+        w.write_header(detail::wkb::wkb_linestring, detail::wkb::has_z(linestring));
+        detail::wkb::write_points(w, linestring);
+    }
+};
+
+template <typename Polygon>
+struct write_wkb<Polygon, polygon_tag>
+{
+    static inline void apply(detail::wkb::writer & w, Polygon const& polygon)
+    {
+        w.write_header(detail::wkb::wkb_polygon, detail::wkb::has_z(polygon));
+        auto const& interiors = geometry::interior_rings(polygon);
+        w.write_count(1 + boost::size(interiors));
+        detail::wkb::write_points(w, geometry::exterior_ring(polygon));
+        for (auto const& ring : interiors)
+        {
+            detail::wkb::write_points(w, ring);
+        }
+    }
+};
+
+template <typename MultiGeometry>
+struct write_wkb_multi
+{
+    static inline void apply(detail::wkb::writer & w, MultiGeometry const& multi)
+    {
+        using value_t = typename boost::range_value<MultiGeometry>::type;
+        w.write_header(detail::wkb::tag_type<typename tag<MultiGeometry>::type>::value,
+                       detail::wkb::has_z(multi));
+        w.write_count(boost::size(multi));
+        for (auto const& element : multi)
+        {
+            write_wkb<value_t>::apply(w, element);
+        }
+    }
+};
+
+template <typename MultiPoint>
+struct write_wkb<MultiPoint, multi_point_tag>
+    : write_wkb_multi<MultiPoint>
+{};
+
+template <typename MultiLinestring>
+struct write_wkb<MultiLinestring, multi_linestring_tag>
+    : write_wkb_multi<MultiLinestring>
+{};
+
+template <typename MultiPolygon>
+struct write_wkb<MultiPolygon, multi_polygon_tag>
+    : write_wkb_multi<MultiPolygon>
+{};
+
+template <typename Geometry>
+struct write_wkb<Geometry, dynamic_geometry_tag>
+{
+    static inline void apply(detail::wkb::writer & w, Geometry const& geometry)
+    {
+        traits::visit<Geometry>::apply([&](auto const& g)
+        {
+            write_wkb<util::remove_cref_t<decltype(g)>>::apply(w, g);
+        }, geometry);
+    }
+};
+
+template <typename Geometry>
+struct write_wkb<Geometry, geometry_collection_tag>
+{
+    static inline void apply(detail::wkb::writer & w, Geometry const& geometry)
+    {
+        w.write_header(detail::wkb::wkb_geometry_collection, detail::wkb::has_z(geometry));
+        w.write_count(boost::size(geometry));
+        for (auto it = boost::begin(geometry); it != boost::end(geometry); ++it)
+        {
+            traits::visit_iterator<Geometry>::apply([&](auto const& g)
+            {
+                write_wkb<util::remove_cref_t<decltype(g)>>::apply(w, g);
+            }, it);
+        }
+    }
+};
+
+} // namespace dispatch
+
+// Reads WKB or EWKB directly from the buffer, e.g. a memory-mapped file, and returns
+// the pointer to the first byte after the geometry. Elements of GeometryCollections
+// are stored with traits::emplace_back as soon as they are read.
+// NOTE: The memory of the geometry passed in is reused if possible, e.g. a linestring
+//   or a multi-geometry read repeatedly into the same object only allocates if it
+//   doesn't have enough capacity. Elements of GeometryCollections are created anew.
+// NOTE: Elements are stored as the first type in geometry_types matching the WKB.
+//   Z is stored if the points have 3 dimensions, M and SRID are ignored.
+// NOTE: read_wkb_exception is thrown if WKB is invalid.
+template <typename Geometry>
+inline std::uint8_t const* read_wkb(std::uint8_t const* first, std::uint8_t const* last, Geometry & geometry)
+{
+    detail::wkb::reader r(first, last);
+    detail::wkb::header const h = r.read_header();
+    dispatch::read_wkb<Geometry>::apply(r, h, geometry);
+    return r.position();
+}
+
+// Appends WKB of the geometry to the vector, in little endian byte order
+template <typename Geometry>
+inline void write_wkb(Geometry const& geometry, std::vector<std::uint8_t> & bytes)
+{
+    detail::wkb::writer w(bytes);
+    dispatch::write_wkb<Geometry>::apply(w, geometry);
+}
+
+// Appends EWKB of the geometry with SRID to the vector, in little endian byte order
+template <typename Geometry>
+inline void write_ewkb(Geometry const& geometry, std::uint32_t srid, std::vector<std::uint8_t> & bytes)
+{
+    detail::wkb::writer w(bytes, srid);
+    dispatch::write_wkb<Geometry>::apply(w, geometry);
+}
+
+}} // namespace boost::geometry
+
+#endif // WKB_HPP
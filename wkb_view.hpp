@@ -0,0 +1,956 @@
+#ifndef WKB_VIEW_HPP
+#define WKB_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/core/ignore_unused.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include "geometry.hpp"
+#include "wkb.hpp"
+
+namespace boost { namespace geometry {
+
+namespace model {
+
+template <typename Point> class wkb_collection_view;
+template <typename Point> class wkb_view;
+
+} // namespace model
+
+namespace detail { namespace wkb_view {
+
+// Byte order and dimensions of points of a geometry
+struct layout
+{
+    bool swap;
+    bool has_z;
+    std::size_t point_size;
+};
+
+// Reads the header of a geometry in a validated buffer and returns the pointer
+// to the first byte after it
+inline std::uint8_t const* read_header(std::uint8_t const* ptr, wkb::header & h, layout & l)
+{
+    l.swap = wkb::swap_bytes(ptr[0]);
+    bool const has_srid = wkb::decode_type(wkb::load<std::uint32_t>(ptr + 1, l.swap), h);
+    l.has_z = h.has_z;
+    l.point_size = wkb::point_size(h);
+    return ptr + (has_srid ? 9 : 5);
+}
+
+inline std::size_t load_count(std::uint8_t const* ptr, layout const& l)
+{
+    return wkb::load<std::uint32_t>(ptr, l.swap);
+}
+
+// Coordinates not stored in WKB are set to 0, M is ignored
+template <typename Point, std::size_t ...Is>
+inline Point load_point(std::uint8_t const* ptr, layout const& l, std::index_sequence<Is...>)
+{
+    using coordinate_t = typename coordinate_type<Point>::type;
+    BOOST_GEOMETRY_STATIC_ASSERT(sizeof...(Is) <= 3,
+        "Points with more than 3 dimensions are not supported.",
+        Point);
+
+    Point point;
+    int dummy[] = { (geometry::set<Is>(point, coordinate_t(Is < 2 || l.has_z
+                                                            ? wkb::load<double>(ptr + 8 * Is, l.swap)
+                                                            : 0)), 0)... };
+    boost::ignore_unused(dummy);
+    return point;
+}
+
+template <typename Point>
+inline Point load_point(std::uint8_t const* ptr, layout const& l)
+{
+    return load_point<Point>(ptr, l, std::make_index_sequence<dimension<Point>::value>());
+}
+
+// Points stored one after another in a linestring or a ring.
+// NOTE: Coordinates in WKB are not aligned so points are decoded when dereferenced
+//   and the iterator returns them by value.
+template <typename Point>
+class point_iterator
+    : public boost::iterator_facade
+        <
+            point_iterator<Point>,
+            Point,
+            boost::random_access_traversal_tag,
+            Point
+        >
+{
+public:
+    point_iterator() = default;
+
+    point_iterator(std::uint8_t const* ptr, layout const& l)
+        : m_ptr(ptr)
+        , m_layout(l)
+    {}
+
+private:
+    friend class boost::iterator_core_access;
+
+    Point dereference() const
+    {
+        return load_point<Point>(m_ptr, m_layout);
+    }
+
+    bool equal(point_iterator const& other) const
+    {
+        return m_ptr == other.m_ptr;
+    }
+
+    void increment() { m_ptr += m_layout.point_size; }
+    void decrement() { m_ptr -= m_layout.point_size; }
+    void advance(std::ptrdiff_t n) { m_ptr += n * std::ptrdiff_t(m_layout.point_size); }
+
+    std::ptrdiff_t distance_to(point_iterator const& other) const
+    {
+        return (other.m_ptr - m_ptr) / std::ptrdiff_t(m_layout.point_size);
+    }
+
+    std::uint8_t const* m_ptr = nullptr;
+    layout m_layout = { false, false, 16 };
+};
+
+// Range of points preceded by their number
+template <typename Range>
+inline Range make_points(std::uint8_t const* ptr, layout const& l)
+{
+    using iterator_t = typename boost::range_iterator<Range const>::type;
+    std::uint8_t const* first = ptr + 4;
+    return Range(iterator_t(first, l), iterator_t(first + load_count(ptr, l) * l.point_size, l));
+}
+
+// Start of an element of a multi-geometry or of a ring of a polygon stored by wkb_view
+// during validation. The entries are stored in pre-order, the entries of elements of
+// a geometry are contiguous and index is the position of the entries of elements of
+// this element, e.g. of rings of a polygon stored in a multi-polygon.
+struct element_entry
+{
+    std::uint8_t const* ptr;
+    std::size_t index;
+};
+
+// Returns the pointer to the first byte after the geometry in a validated buffer and
+// moves index past the entries of the geometry. The last element of a multi-geometry
+// or the last ring of a polygon is found in entries so elements are not traversed.
+// NOTE: GeometryCollections are not stored in entries, they're skipped by
+//   collection_iterator.
+inline std::uint8_t const* skip(std::uint8_t const* ptr, element_entry const* entries, std::size_t & index)
+{
+    wkb::header h;
+    layout l;
+    ptr = read_header(ptr, h, l);
+    switch (h.type)
+    {
+    case wkb::wkb_point:
+        return ptr + l.point_size;
+    case wkb::wkb_linestring:
+        return ptr + 4 + load_count(ptr, l) * l.point_size;
+    case wkb::wkb_polygon:
+    {
+        std::size_t const rings = load_count(ptr, l);
+        if (rings == 0)
+        {
+            return ptr + 4;
+        }
+        index += rings;
+        std::uint8_t const* const last = entries[index - 1].ptr;
+        return last + 4 + load_count(last, l) * l.point_size;
+    }
+    default:
+    {
+        std::size_t const count = load_count(ptr, l);
+        if (count == 0)
+        {
+            return ptr + 4;
+        }
+        element_entry const& last = entries[index + count - 1];
+        index = last.index;
+        return skip(last.ptr, entries, index);
+    }
+    }
+}
+
+// Elements of a multi-geometry, each stored with its own header, or rings of
+// a polygon, each preceded by the number of points.
+// NOTE: The elements have different sizes so the iterator points to their entries
+//   stored by wkb_view during validation.
+template <typename Geometry>
+class element_iterator
+    : public boost::iterator_facade
+        <
+            element_iterator<Geometry>,
+            Geometry,
+            boost::random_access_traversal_tag,
+            Geometry
+        >
+{
+public:
+    element_iterator() = default;
+
+    element_iterator(element_entry const* entry, element_entry const* entries, layout const& l)
+        : m_entry(entry)
+        , m_entries(entries)
+        , m_layout(l)
+    {}
+
+private:
+    friend class boost::iterator_core_access;
+
+    Geometry dereference() const
+    {
+        return make(typename tag<Geometry>::type());
+    }
+
+    Geometry make(point_tag) const
+    {
+        wkb::header h;
+        layout l;
+        return load_point<Geometry>(read_header(m_entry->ptr, h, l), l);
+    }
+
+    Geometry make(ring_tag) const
+    {
+        return make_points<Geometry>(m_entry->ptr, m_layout);
+    }
+
+    Geometry make(linestring_tag) const
+    {
+        return Geometry(m_entry->ptr);
+    }
+
+    Geometry make(polygon_tag) const
+    {
+        return Geometry(m_entry->ptr, m_entries, m_entry->index);
+    }
+
+    bool equal(element_iterator const& other) const
+    {
+        return m_entry == other.m_entry;
+    }
+
+    void increment() { ++m_entry; }
+    void decrement() { --m_entry; }
+    void advance(std::ptrdiff_t n) { m_entry += n; }
+
+    std::ptrdiff_t distance_to(element_iterator const& other) const
+    {
+        return other.m_entry - m_entry;
+    }
+
+    element_entry const* m_entry = nullptr;
+    element_entry const* m_entries = nullptr;
+    layout m_layout = { false, false, 16 };
+};
+
+// Multi-geometry starting at ptr, the entries of elements start at index
+template <typename Geometry>
+inline boost::iterator_range<element_iterator<Geometry>> make_elements(std::uint8_t const* ptr,
+                                                                        element_entry const* entries,
+                                                                        std::size_t index)
+{
+    wkb::header h;
+    layout l;
+    ptr = read_header(ptr, h, l);
+    element_entry const* const first = entries + index;
+    return boost::iterator_range<element_iterator<Geometry>>(
+        element_iterator<Geometry>(first, entries, l),
+        element_iterator<Geometry>(first + load_count(ptr, l), entries, l));
+}
+
+// Element of wkb_collection_view, the index of the first GeometryCollection stored
+// in it or after it and the index of the first element_entry stored for it or after
+// it are kept so nested GeometryCollections and elements can be found
+struct element
+{
+    std::uint8_t const* ptr;
+    std::size_t collection;
+    std::size_t entry;
+};
+
+template <typename Point>
+class collection_iterator
+    : public boost::iterator_facade
+        <
+            collection_iterator<Point>,
+            element,
+            boost::forward_traversal_tag,
+            element
+        >
+{
+    using view_t = model::wkb_collection_view<Point>;
+
+public:
+    collection_iterator() = default;
+
+    collection_iterator(view_t const* collections, element_entry const* entries,
+                        std::uint8_t const* ptr, std::size_t index,
+                        std::size_t collection, std::size_t entry)
+        : m_collections(collections)
+        , m_entries(entries)
+        , m_ptr(ptr)
+        , m_index(index)
+        , m_collection(collection)
+        , m_entry(entry)
+    {}
+
+    view_t const* collections() const
+    {
+        return m_collections;
+    }
+
+    element_entry const* entries() const
+    {
+        return m_entries;
+    }
+
+private:
+    friend class boost::iterator_core_access;
+
+    element dereference() const
+    {
+        return element{ m_ptr, m_collection, m_entry };
+    }
+
+    bool equal(collection_iterator const& other) const
+    {
+        return m_index == other.m_index;
+    }
+
+    // Nested GeometryCollections are skipped with the sizes found during validation
+    void increment()
+    {
+        wkb::header h;
+        layout l;
+        read_header(m_ptr, h, l);
+        if (h.type == wkb::wkb_geometry_collection)
+        {
+            view_t const& nested = m_collections[m_collection];
+            m_ptr = nested.m_last;
+            m_collection += 1 + nested.m_nested;
+            m_entry = nested.m_last_entry;
+        }
+        else
+        {
+            m_ptr = skip(m_ptr, m_entries, m_entry);
+        }
+        ++m_index;
+    }
+
+    view_t const* m_collections = nullptr;
+    element_entry const* m_entries = nullptr;
+    std::uint8_t const* m_ptr = nullptr;
+    std::size_t m_index = 0;
+    std::size_t m_collection = 0;
+    std::size_t m_entry = 0;
+};
+
+}} // namespace detail::wkb_view
+
+namespace model {
+
+// Views of geometries stored in WKB, see wkb_view
+
+template <typename Point>
+struct wkb_linestring_view : boost::iterator_range<geometry::detail::wkb_view::point_iterator<Point>>
+{
+    using boost::iterator_range<geometry::detail::wkb_view::point_iterator<Point>>::iterator_range;
+
+    explicit wkb_linestring_view(std::uint8_t const* ptr)
+        : wkb_linestring_view(make(ptr))
+    {}
+
+private:
+    static wkb_linestring_view make(std::uint8_t const* ptr)
+    {
+        geometry::detail::wkb::header h;
+        geometry::detail::wkb_view::layout l;
+        ptr = geometry::detail::wkb_view::read_header(ptr, h, l);
+        return geometry::detail::wkb_view::make_points<wkb_linestring_view>(ptr, l);
+    }
+};
+
+template <typename Point>
+struct wkb_ring_view : boost::iterator_range<geometry::detail::wkb_view::point_iterator<Point>>
+{
+    using boost::iterator_range<geometry::detail::wkb_view::point_iterator<Point>>::iterator_range;
+};
+
+// The exterior ring followed by interior rings
+template <typename Point>
+class wkb_polygon_view
+{
+    using ring_iterator_t = geometry::detail::wkb_view::element_iterator<wkb_ring_view<Point>>;
+
+public:
+    using inners_type = boost::iterator_range<ring_iterator_t>;
+
+    // The entries of rings start at index
+    wkb_polygon_view(std::uint8_t const* ptr,
+                     geometry::detail::wkb_view::element_entry const* entries, std::size_t index)
+        : m_entries(entries + index)
+    {
+        geometry::detail::wkb::header h;
+        ptr = geometry::detail::wkb_view::read_header(ptr, h, m_layout);
+        m_rings = geometry::detail::wkb_view::load_count(ptr, m_layout);
+        m_first = ptr + 4;
+    }
+
+    // NOTE: The exterior ring of an empty polygon is empty
+    wkb_ring_view<Point> outer() const
+    {
+        return m_rings > 0
+             ? geometry::detail::wkb_view::make_points<wkb_ring_view<Point>>(m_first, m_layout)
+             : wkb_ring_view<Point>();
+    }
+
+    inners_type inners() const
+    {
+        ring_iterator_t const last(m_entries + m_rings, nullptr, m_layout);
+        return m_rings > 1
+             ? inners_type(ring_iterator_t(m_entries + 1, nullptr, m_layout), last)
+             : inners_type(last, last);
+    }
+
+private:
+    geometry::detail::wkb_view::element_entry const* m_entries;
+    std::uint8_t const* m_first;
+    std::size_t m_rings;
+    geometry::detail::wkb_view::layout m_layout;
+};
+
+template <typename Point>
+struct wkb_multi_point_view
+    : boost::iterator_range<geometry::detail::wkb_view::element_iterator<Point>>
+{
+    wkb_multi_point_view(std::uint8_t const* ptr,
+                         geometry::detail::wkb_view::element_entry const* entries, std::size_t index)
+        : wkb_multi_point_view::iterator_range(
+            geometry::detail::wkb_view::make_elements<Point>(ptr, entries, index))
+    {}
+};
+
+template <typename Point>
+struct wkb_multi_linestring_view
+    : boost::iterator_range<geometry::detail::wkb_view::element_iterator<wkb_linestring_view<Point>>>
+{
+    wkb_multi_linestring_view(std::uint8_t const* ptr,
+                              geometry::detail::wkb_view::element_entry const* entries, std::size_t index)
+        : wkb_multi_linestring_view::iterator_range(
+            geometry::detail::wkb_view::make_elements<wkb_linestring_view<Point>>(ptr, entries, index))
+    {}
+};
+
+template <typename Point>
+struct wkb_multi_polygon_view
+    : boost::iterator_range<geometry::detail::wkb_view::element_iterator<wkb_polygon_view<Point>>>
+{
+    wkb_multi_polygon_view(std::uint8_t const* ptr,
+                           geometry::detail::wkb_view::element_entry const* entries, std::size_t index)
+        : wkb_multi_polygon_view::iterator_range(
+            geometry::detail::wkb_view::make_elements<wkb_polygon_view<Point>>(ptr, entries, index))
+    {}
+};
+
+// GeometryCollection stored in WKB, created by wkb_view during validation.
+// NOTE: Views of all GeometryCollections are stored by wkb_view contiguously in
+//   pre-order so the iterator finds nested ones by counting GeometryCollections
+//   it passes. Every view points to this array so its copies can be iterated as
+//   long as the wkb_view exists.
+template <typename Point>
+class wkb_collection_view
+{
+public:
+    using value_type = geometry::detail::wkb_view::element;
+    using size_type = std::size_t;
+    using iterator = geometry::detail::wkb_view::collection_iterator<Point>;
+    using const_iterator = iterator;
+
+    // The elements are stored between first and last, index is the position of this
+    // view, nested is the number of GeometryCollections nested in it at all levels and
+    // the entries of elements stored in it are between first_entry and last_entry
+    wkb_collection_view(std::uint8_t const* first, std::uint8_t const* last, std::size_t size,
+                        std::size_t index, std::size_t nested,
+                        std::size_t first_entry, std::size_t last_entry)
+        : m_first(first)
+        , m_last(last)
+        , m_size(size)
+        , m_index(index)
+        , m_nested(nested)
+        , m_first_entry(first_entry)
+        , m_last_entry(last_entry)
+    {}
+
+    const_iterator begin() const
+    {
+        return const_iterator(m_collections, m_entries, m_first, 0, m_index + 1, m_first_entry);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(m_collections, m_entries, m_last, m_size, 0, m_last_entry);
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    friend class geometry::detail::wkb_view::collection_iterator<Point>;
+    friend class wkb_view<Point>;
+
+    wkb_collection_view const* m_collections = nullptr;
+    geometry::detail::wkb_view::element_entry const* m_entries = nullptr;
+    std::uint8_t const* m_first;
+    std::uint8_t const* m_last;
+    std::size_t m_size;
+    std::size_t m_index;
+    std::size_t m_nested;
+    std::size_t m_first_entry;
+    std::size_t m_last_entry;
+};
+
+} // namespace model
+
+namespace detail { namespace wkb_view {
+
+template <typename View, typename Function, typename ...Args>
+inline void call_view(Function & function, std::uint8_t const* ptr, Args const& ...args)
+{
+    View const view(ptr, args...);
+    function(view);
+}
+
+template <typename Point, typename Function>
+inline void visit_element(Function & function, element const& e,
+                          model::wkb_collection_view<Point> const* collections,
+                          element_entry const* entries)
+{
+    wkb::header h;
+    layout l;
+    std::uint8_t const* body = read_header(e.ptr, h, l);
+    switch (h.type)
+    {
+    case wkb::wkb_point:
+    {
+        Point const point = load_point<Point>(body, l);
+        function(point);
+        break;
+    }
+    case wkb::wkb_linestring: call_view<model::wkb_linestring_view<Point>>(function, e.ptr); break;
+    case wkb::wkb_polygon: call_view<model::wkb_polygon_view<Point>>(function, e.ptr, entries, e.entry); break;
+    case wkb::wkb_multi_point: call_view<model::wkb_multi_point_view<Point>>(function, e.ptr, entries, e.entry); break;
+    case wkb::wkb_multi_linestring: call_view<model::wkb_multi_linestring_view<Point>>(function, e.ptr, entries, e.entry); break;
+    case wkb::wkb_multi_polygon: call_view<model::wkb_multi_polygon_view<Point>>(function, e.ptr, entries, e.entry); break;
+    default: function(collections[e.collection]); break;
+    }
+}
+
+// Checks the sizes of all geometries and stores views of GeometryCollections and entries
+// of elements of multi-geometries and rings of polygons in pre-order
+template <typename Point>
+inline void validate(wkb::reader & r, wkb::geometry_type expected,
+                     std::vector<model::wkb_collection_view<Point>> & collections,
+                     std::vector<element_entry> & entries)
+{
+    wkb::header const h = r.read_header();
+    if (expected != wkb::wkb_unknown && h.type != expected)
+    {
+        BOOST_THROW_EXCEPTION(read_wkb_exception("Unexpected geometry type"));
+    }
+    std::size_t const point_size = wkb::point_size(h);
+    switch (h.type)
+    {
+    case wkb::wkb_point:
+        r.skip(point_size);
+        break;
+    case wkb::wkb_linestring:
+        r.skip(r.read_count(point_size) * point_size);
+        break;
+    case wkb::wkb_polygon:
+    {
+        std::size_t const rings = r.read_count(4);
+        for (std::size_t i = 0; i < rings; ++i)
+        {
+            entries.push_back(element_entry{ r.position(), entries.size() });
+            r.skip(r.read_count(point_size) * point_size);
+        }
+        break;
+    }
+    case wkb::wkb_multi_point:
+    case wkb::wkb_multi_linestring:
+    case wkb::wkb_multi_polygon:
+    {
+        // Types of elements are 3 less than types of multi-geometries
+        wkb::geometry_type const element_type = wkb::geometry_type(h.type - 3);
+        std::size_t const count = r.read_count(5);
+        // Entries of elements are stored before the entries of their rings
+        std::size_t const first = entries.size();
+        entries.resize(first + count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            entries[first + i] = element_entry{ r.position(), entries.size() };
+            validate(r, element_type, collections, entries);
+        }
+        break;
+    }
+    default:
+    {
+        std::size_t const count = r.read_count(5);
+        std::uint8_t const* first = r.position();
+        std::size_t const index = collections.size();
+        std::size_t const first_entry = entries.size();
+        collections.emplace_back(first, first, count, index, 0, first_entry, first_entry);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            validate(r, wkb::wkb_unknown, collections, entries);
+        }
+        collections[index] = model::wkb_collection_view<Point>(first, r.position(), count, index,
+                                                               collections.size() - index - 1,
+                                                               first_entry, entries.size());
+        break;
+    }
+    }
+}
+
+template <typename Point>
+inline std::uint8_t const* validate(std::uint8_t const* first, std::uint8_t const* last,
+                                    std::vector<model::wkb_collection_view<Point>> & collections,
+                                    std::vector<element_entry> & entries)
+{
+    wkb::reader r(first, last);
+    validate(r, wkb::wkb_unknown, collections, entries);
+    return r.position();
+}
+
+// Copies of views of StaticGeometries of each type. The views are created on the fly
+// during traversal so they can't be referenced like StaticGeometries stored in
+// other GeometryCollections.
+template <typename TypeSequence>
+class groups;
+
+template <typename ...Ts>
+class groups<util::type_sequence<Ts...>>
+{
+    using types_t = util::type_sequence<Ts...>;
+
+public:
+    template <typename G>
+    void add(G const& g)
+    {
+        static const std::size_t I = sequence_index<G, types_t>::value;
+        std::get<I>(m_geometries).push_back(g);
+    }
+
+    template <typename F>
+    bool call(F & f) const
+    {
+        return call<0>(f);
+    }
+
+private:
+    template <std::size_t I, typename F, std::enable_if_t<(I < sizeof...(Ts)), int> = 0>
+    bool call(F & f) const
+    {
+        auto const& geometries = std::get<I>(m_geometries);
+        if (! geometries.empty() && ! detail::call_visit_function(f, geometries))
+        {
+            return false;
+        }
+        return call<I + 1>(f);
+    }
+    template <std::size_t I, typename F, std::enable_if_t<(I >= sizeof...(Ts)), int> = 0>
+    bool call(F & ) const
+    {
+        return true;
+    }
+
+    std::tuple<std::vector<Ts>...> m_geometries;
+};
+
+}} // namespace detail::wkb_view
+
+namespace model {
+
+// Read-only DynamicGeometry viewing WKB or EWKB stored in memory, e.g. in a
+// memory-mapped file or in a database blob:
+//     model::wkb_view<point_t> view(bytes.data(), bytes.data() + bytes.size());
+//     double const length = geometry::length(view);
+// Coordinates are not copied, geometries are visited as Point, wkb_linestring_view,
+// wkb_polygon_view, wkb_multi_point_view, wkb_multi_linestring_view,
+// wkb_multi_polygon_view and wkb_collection_view pointing into the buffer.
+// The buffer is validated once in the constructor and read_wkb_exception is thrown
+// if it's invalid. Only a view of every GeometryCollection and the position of every
+// element of multi-geometries and every ring of polygons are stored so the elements
+// and rings can be accessed in constant time.
+// NOTE: Points are decoded when they are accessed because coordinates in WKB are not
+//   aligned and their byte order may be different than the native one.
+// NOTE: Rings of polygons are expected to be closed and clockwise like in
+//   model::polygon by default.
+// NOTE: The buffer has to outlive the view and the views of its geometries.
+//   Nested GeometryCollections are viewed by the views stored in wkb_view and the
+//   positions of elements are stored in wkb_view so the wkb_view has to outlive
+//   the views of its geometries too.
+// NOTE: Views of StaticGeometries are created during traversal so algorithms storing
+//   references to StaticGeometries, e.g. collection_rtree and distance, can't be used,
+//   see traits::visit_yields_temporaries.
+template <typename Point>
+class wkb_view
+{
+public:
+    wkb_view(std::uint8_t const* first, std::uint8_t const* last)
+        : m_first(first)
+    {
+        m_last = geometry::detail::wkb_view::validate(first, last, m_collections, m_entries);
+        bind();
+    }
+
+    // Views of GeometryCollections of a copy point to the copied arrays, the arrays
+    // are not reallocated when the view is moved
+    wkb_view(wkb_view const& other)
+        : m_first(other.m_first)
+        , m_last(other.m_last)
+        , m_collections(other.m_collections)
+        , m_entries(other.m_entries)
+    {
+        bind();
+    }
+
+    wkb_view(wkb_view &&) = default;
+
+    wkb_view & operator=(wkb_view const& other)
+    {
+        m_first = other.m_first;
+        m_last = other.m_last;
+        m_collections = other.m_collections;
+        m_entries = other.m_entries;
+        bind();
+        return *this;
+    }
+
+    wkb_view & operator=(wkb_view &&) = default;
+
+    // Pointer to the first byte after the geometry
+    std::uint8_t const* last() const
+    {
+        return m_last;
+    }
+
+    template <typename Function>
+    void visit(Function && function) const
+    {
+        geometry::detail::wkb_view::visit_element<Point>(function,
+            geometry::detail::wkb_view::element{ m_first, 0, 0 },
+            m_collections.data(), m_entries.data());
+    }
+
+private:
+    void bind()
+    {
+        for (wkb_collection_view<Point> & collection : m_collections)
+        {
+            collection.m_collections = m_collections.data();
+            collection.m_entries = m_entries.data();
+        }
+    }
+
+    std::uint8_t const* m_first;
+    std::uint8_t const* m_last;
+    std::vector<wkb_collection_view<Point>> m_collections;
+    std::vector<geometry::detail::wkb_view::element_entry> m_entries;
+};
+
+} // namespace model
+
+namespace traits {
+
+template <typename Point>
+struct tag<model::wkb_linestring_view<Point>>
+{
+    typedef linestring_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_ring_view<Point>>
+{
+    typedef ring_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_polygon_view<Point>>
+{
+    typedef polygon_tag type;
+};
+
+// NOTE: Rings are created on the fly so they're returned by value
+template <typename Point>
+struct ring_const_type<model::wkb_polygon_view<Point>>
+{
+    typedef model::wkb_ring_view<Point> type;
+};
+
+template <typename Point>
+struct ring_mutable_type<model::wkb_polygon_view<Point>>
+{
+    typedef model::wkb_ring_view<Point> type;
+};
+
+template <typename Point>
+struct interior_const_type<model::wkb_polygon_view<Point>>
+{
+    typedef typename model::wkb_polygon_view<Point>::inners_type type;
+};
+
+template <typename Point>
+struct interior_mutable_type<model::wkb_polygon_view<Point>>
+{
+    typedef typename model::wkb_polygon_view<Point>::inners_type type;
+};
+
+template <typename Point>
+struct exterior_ring<model::wkb_polygon_view<Point>>
+{
+    static model::wkb_ring_view<Point> get(model::wkb_polygon_view<Point> const& p)
+    {
+        return p.outer();
+    }
+};
+
+template <typename Point>
+struct interior_rings<model::wkb_polygon_view<Point>>
+{
+    static typename model::wkb_polygon_view<Point>::inners_type get(model::wkb_polygon_view<Point> const& p)
+    {
+        return p.inners();
+    }
+};
+
+template <typename Point>
+struct tag<model::wkb_multi_point_view<Point>>
+{
+    typedef multi_point_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_multi_linestring_view<Point>>
+{
+    typedef multi_linestring_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_multi_polygon_view<Point>>
+{
+    typedef multi_polygon_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_collection_view<Point>>
+{
+    typedef geometry_collection_tag type;
+};
+
+template <typename Point>
+struct tag<model::wkb_view<Point>>
+{
+    typedef dynamic_geometry_tag type;
+};
+
+template <typename Point>
+struct geometry_types<model::wkb_collection_view<Point>>
+{
+    typedef util::type_sequence
+        <
+            Point,
+            model::wkb_linestring_view<Point>,
+            model::wkb_polygon_view<Point>,
+            model::wkb_multi_point_view<Point>,
+            model::wkb_multi_linestring_view<Point>,
+            model::wkb_multi_polygon_view<Point>,
+            model::wkb_collection_view<Point>
+        > type;
+};
+
+template <typename Point>
+struct geometry_types<model::wkb_view<Point>>
+    : geometry_types<model::wkb_collection_view<Point>>
+{};
+
+template <typename Point>
+struct visit_iterator<model::wkb_collection_view<Point>>
+{
+    template <typename Function, typename Iterator>
+    static void apply(Function && function, Iterator iterator)
+    {
+        geometry::detail::wkb_view::visit_element<Point>(function, *iterator, iterator.collections(),
+                                                         iterator.entries());
+    }
+};
+
+template <typename Point>
+struct visit<model::wkb_view<Point>>
+{
+    template <typename Function>
+    static void apply(Function && function, model::wkb_view<Point> const& view)
+    {
+        view.visit(function);
+    }
+};
+
+template <typename Point>
+struct visit_yields_temporaries<model::wkb_collection_view<Point>>
+    : std::true_type
+{};
+
+template <typename Point>
+struct visit_yields_temporaries<model::wkb_view<Point>>
+    : std::true_type
+{};
+
+} // namespace traits
+
+namespace dispatch
+{
+
+template <typename Point>
+struct visit_grouped<model::wkb_collection_view<Point>, geometry_collection_tag>
+{
+    template <typename F, typename Geom>
+    static bool apply(F & function, Geom & geom)
+    {
+        // GeometryCollections are never passed into the function
+        using types_t = util::type_sequence
+            <
+                Point,
+                model::wkb_linestring_view<Point>,
+                model::wkb_polygon_view<Point>,
+                model::wkb_multi_point_view<Point>,
+                model::wkb_multi_linestring_view<Point>,
+                model::wkb_multi_polygon_view<Point>
+            >;
+        detail::wkb_view::groups<types_t> groups;
+        geometry::visit_depth_first([&](auto const& g)
+        {
+            groups.add(g);
+        }, geom);
+        return groups.call(function);
+    }
+};
+
+template <typename Point>
+struct visit_grouped<model::wkb_view<Point>, dynamic_geometry_tag>
+    : visit_grouped<model::wkb_collection_view<Point>, geometry_collection_tag>
+{};
+
+} // namespace dispatch
+
+}} // namespace boost::geometry
+
+#endif // WKB_VIEW_HPP